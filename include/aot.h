@@ -0,0 +1,72 @@
+#ifndef AOT_H
+#define AOT_H
+
+#include "chip8.h"
+#include <stddef.h>     // Para offsetof
+
+// --- TRADUCCIÓN ANTICIPADA (AOT) ---
+// tools/aot.c desensambla una ROM desde START_ADDRESS y genera código C con
+// una función por bloque básico. Ese código se compila como biblioteca
+// compartida (.so) y el emulador la carga con dlopen. Las direcciones sin
+// bloque, o cuyo código ha cambiado en memoria, se ejecutan con el intérprete.
+
+// Versión del formato. Cambia si cambian estas estructuras o chip8_t.
+#define CHIP8_AOT_ABI 2
+
+// Posición dentro de chip8_t de cada campo que usa el código generado. El módulo
+// guarda las que vio al compilarse y el cargador las compara con las suyas: así
+// un cambio de disposición con el mismo tamaño total también se detecta.
+#define CHIP8_AOT_FIELD_COUNT 12
+#define CHIP8_AOT_OFFSETS { \
+    offsetof(chip8_t, memory), offsetof(chip8_t, V), offsetof(chip8_t, I), \
+    offsetof(chip8_t, pc), offsetof(chip8_t, stack), offsetof(chip8_t, sp), \
+    offsetof(chip8_t, keypad), offsetof(chip8_t, delay_timer), \
+    offsetof(chip8_t, sound_timer), offsetof(chip8_t, written_start), \
+    offsetof(chip8_t, written_end), offsetof(chip8_t, watch) }
+
+// Símbolo que exporta cada módulo generado
+#define CHIP8_AOT_SYMBOL "chip8_aot_module"
+
+// Función del intérprete a la que el código generado delega algunas instrucciones
+typedef void (*chip8_aot_exec_fn)(chip8_t *chip8, uint16_t opcode);
+
+// Un bloque básico traducido
+typedef struct {
+    uint16_t addr;              // Dirección de la primera instrucción
+    uint16_t length;            // Bytes de código que cubre el bloque
+    const uint8_t *code;        // Bytes originales (para detectar código automodificado)
+    // Ejecuta como mucho 'budget' instrucciones (>= 1) y deja el PC en la siguiente.
+    // Devuelve cuántas ejecutó.
+    int (*run)(chip8_t *chip8, int budget);
+} chip8_aot_block_t;
+
+// Descripción del módulo completo (variable global CHIP8_AOT_SYMBOL)
+typedef struct {
+    uint32_t abi;               // CHIP8_AOT_ABI con el que se generó
+    uint32_t state_size;        // sizeof(chip8_t) con el que se compiló
+    uint32_t offsets[CHIP8_AOT_FIELD_COUNT];    // CHIP8_AOT_OFFSETS con el que se compiló
+    int block_count;
+    const chip8_aot_block_t *blocks;
+    void (*bind)(chip8_aot_exec_fn exec);
+} chip8_aot_module_t;
+
+// Módulo cargado en el emulador
+typedef struct {
+    void *handle;                                   // Resultado de dlopen
+    const chip8_aot_module_t *module;
+    const chip8_aot_block_t *table[RAM_SIZE];       // Bloque por dirección (o NULL)
+    const chip8_aot_block_t *ready[RAM_SIZE];       // Bloques ya comparados con la memoria
+    bool code[RAM_SIZE];            // Byte cubierto por algún bloque
+    int max_length;                 // Bytes del bloque más largo
+} chip8_aot_t;
+
+// Carga un módulo .so generado por tools/aot. Devuelve false si no es compatible.
+bool chip8_aot_load(chip8_aot_t *aot, const char *path);
+
+// Ejecuta exactamente 'cycles' instrucciones, con código nativo cuando es posible
+void chip8_aot_run(chip8_aot_t *aot, chip8_t *chip8, int cycles);
+
+// Descarga el módulo
+void chip8_aot_unload(chip8_aot_t *aot);
+
+#endif
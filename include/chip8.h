@@ -4,7 +4,7 @@
 #include <stdint.h>     // Para uint8_t, uint16_t, etc.
 #include <stdbool.h>    // Para tipo bool, true, false
 #include <string.h>     // Para memset (usado en la inicialización)
-#include <stdlib.h>     // Para rand()
+#include <stdlib.h>     // Para NULL, size_t
 
 // --- CONSTANTES DEL SISTEMA ---
 
@@ -33,6 +33,19 @@
 // Dirección donde cargaremos la fuente tipográfica (sprites de 0-F).
 #define FONTSET_START_ADDRESS 0x50
 
+// --- FALLOS DE EJECUCIÓN ---
+// Bits de chip8_t.fault. El núcleo nunca aborta: registra el fallo, ignora
+// la instrucción problemática y sigue. Quien ejecuta la máquina decide qué hacer.
+#define CHIP8_FAULT_UNKNOWN_OPCODE  0x01    // Opcode no implementado
+#define CHIP8_FAULT_STACK_OVERFLOW  0x02    // CALL con la pila llena
+#define CHIP8_FAULT_STACK_UNDERFLOW 0x04    // RET con la pila vacía
+#define CHIP8_FAULT_I_RANGE         0x08    // Acceso a memoria[I + n] fuera de la RAM
+#define CHIP8_FAULT_PC_RANGE        0x10    // El PC se salió de la RAM
+#define CHIP8_FAULT_KEY_RANGE       0x20    // EX9E/EXA1 con Vx > 0xF
+
+// Depurador con breakpoints y watchpoints (definido en debug.h)
+struct chip8_debugger;
+
 // Estructura que representa el estado completo de la máquina CHIP-8
 typedef struct {
     // -- MEMORIA --
@@ -68,6 +81,10 @@ typedef struct {
     // 1 = Píxel encendido, 0 = Píxel apagado.
     uint8_t display[SCREEN_WIDTH * SCREEN_HEIGHT];
     
+    // Hash Zobrist de display[]. DXYN lo actualiza con cada píxel que cambia
+    // y 00E0 lo pone a 0, así que leerlo no cuesta nada (ver chip8_display_hash).
+    uint64_t display_hash;
+
     // -- TECLADO --
     // Almacena el estado actual de las 16 teclas.
     // true = Presionada, false = Soltada.
@@ -85,7 +102,28 @@ typedef struct {
     // -- EXTRAS --
     // Bandera para indicar si hay que dibujar en este cicle (optimización).
     bool draw_flag;
-    
+
+    // Estado del generador pseudoaleatorio de CXNN (xorshift32).
+    // Va dentro de la máquina para que cada instancia sea determinista e independiente.
+    uint32_t rng_state;
+
+    // Rango [written_start, written_end) de RAM escrito por el programa (FX33, FX55)
+    // desde la última vez que alguien lo consumió y lo vació (start == end).
+    // El código traducido (aot.h) solo revisa los bloques que se solapan con él.
+    uint16_t written_start;
+    uint16_t written_end;
+
+    // Fallos acumulados (bits CHIP8_FAULT_*). Se limpian a mano con chip8->fault = 0.
+    uint8_t fault;
+
+    // Opcode y dirección de la última instrucción que provocó un fallo
+    uint16_t fault_opcode;
+    uint16_t fault_pc;
+
+    // Depurador a avisar en cada acceso a memoria hecho a través de I.
+    // Es NULL mientras no haya watchpoints: así el coste es un único if.
+    struct chip8_debugger *watch;
+
 } chip8_t;
 
 // Inicializa o reinicia la máquina CHIP-8
@@ -94,6 +132,9 @@ void chip8_init(chip8_t *chip8);
 // Ejecuta un cicle de CPU (una instrucción)
 void chip8_cycle(chip8_t *chip8);
 
+// Decodifica y ejecuta un opcode ya leído (el PC debe apuntar a la instrucción siguiente)
+void chip8_execute(chip8_t *chip8, uint16_t opcode);
+
 // Actualiza los temporizadores del sistema 60 veces/s
 void chip8_update_timers(chip8_t *chip8);
 
@@ -101,4 +142,15 @@ void chip8_update_timers(chip8_t *chip8);
 // Retorna true si tuvo éxito, false si falló.
 bool chip8_load_rom(chip8_t *chip8, const char *filename);
 
+// Hash de 64 bits de la pantalla actual, en O(1).
+// Dos pantallas iguales tienen el mismo hash; la pantalla vacía vale 0.
+uint64_t chip8_display_hash(const chip8_t *chip8);
+
+// El mismo hash recalculado desde cero recorriendo display[] (lento).
+// Siempre coincide con chip8_display_hash(); sirve para comprobarlo.
+uint64_t chip8_display_hash_full(const chip8_t *chip8);
+
+// Describe un bit de fallo (CHIP8_FAULT_*) en texto
+const char *chip8_fault_name(uint8_t fault);
+
 #endif
\ No newline at end of file
@@ -3,6 +3,120 @@
 
 #include "chip8.h"
 
+// --- BREAKPOINTS Y WATCHPOINTS ---
+// Cada dirección de memoria tiene un byte de banderas. Solo se consultan
+// cuando hay algo armado: sin puntos, debug_run() es el bucle normal de
+// chip8_cycle() y chip8->watch es NULL.
+//
+// Los watchpoints solo ven los accesos a memoria hechos a través de I (sprites
+// de DXYN, FX33, FX55 y FX65), no la lectura de opcodes. Además, la ejecución
+// se detiene después de la instrucción que hizo el acceso: lo escrito ya está
+// en memoria y el PC apunta a la instrucción siguiente.
+
+// Bits de chip8_debugger_t.flags[dirección]
+#define DEBUG_FLAG_BREAK    0x01    // Breakpoint incondicional en esta dirección
+#define DEBUG_FLAG_COND     0x02    // Hay breakpoints condicionales en esta dirección
+#define DEBUG_FLAG_READ     0x04    // Watchpoint de lectura
+#define DEBUG_FLAG_WRITE    0x08    // Watchpoint de escritura
+
+#define DEBUG_MAX_CONDITIONS 16
+#define DEBUG_MAX_WATCHES 16
+
+// Registro "16" en una condición = registro I
+#define DEBUG_REG_I 16
+
+// Motivo por el que se detuvo la ejecución
+typedef enum {
+    DEBUG_STOP_NONE,
+    DEBUG_STOP_BREAK,       // PC llegó a un breakpoint (antes de ejecutarlo)
+    DEBUG_STOP_READ,        // Una instrucción leyó memoria vigilada
+    DEBUG_STOP_WRITE        // Una instrucción escribió memoria vigilada
+} debug_stop_t;
+
+// Breakpoint condicional: se detiene en addr solo si "reg cmp value" es cierto.
+// cmp es uno de: '=' (==), '!' (!=), '<', '>', 'l' (<=), 'g' (>=).
+typedef struct {
+    uint16_t addr;
+    uint8_t reg;
+    char cmp;
+    uint16_t value;
+} debug_condition_t;
+
+// Watchpoint sobre el rango [first, last] (flags = DEBUG_FLAG_READ y/o DEBUG_FLAG_WRITE)
+typedef struct {
+    uint16_t first;
+    uint16_t last;
+    uint8_t flags;
+} debug_watch_t;
+
+typedef struct chip8_debugger {
+    // Máquina vigilada
+    chip8_t *chip8;
+
+    // Banderas DEBUG_FLAG_* por dirección
+    uint8_t flags[RAM_SIZE];
+
+    debug_condition_t conditions[DEBUG_MAX_CONDITIONS];
+    int condition_count;
+
+    // Rangos vigilados (para poder quitarlos y rehacer las banderas)
+    debug_watch_t watches[DEBUG_MAX_WATCHES];
+
+    // Contadores de puntos armados (0 = camino rápido)
+    int break_count;
+    int watch_count;        // Entradas usadas de watches[]
+
+    // Última parada
+    debug_stop_t stop;
+    uint16_t stop_addr;     // PC del breakpoint o dirección de memoria accedida
+    uint16_t stop_pc;       // Instrucción que provocó la parada
+
+    // Al reanudar sobre un breakpoint, la primera instrucción no vuelve a detenerse
+    bool resuming;
+} chip8_debugger_t;
+
 void chip8_debug_print(chip8_t *chip8);
 
-#endif
\ No newline at end of file
+// Prepara el depurador para la máquina indicada (sin puntos armados)
+void debug_init(chip8_debugger_t *dbg, chip8_t *chip8);
+
+// Si addr no tiene breakpoints, pone uno incondicional; si tiene alguno (también
+// condicional), los quita todos. Devuelve si queda alguno armado.
+bool debug_toggle_break(chip8_debugger_t *dbg, uint16_t addr);
+
+// Añade un breakpoint condicional. Devuelve false si no queda espacio.
+bool debug_add_condition(chip8_debugger_t *dbg, uint16_t addr, uint8_t reg, char cmp, uint16_t value);
+
+// Vigila las direcciones [first, last] (flags = DEBUG_FLAG_READ y/o DEBUG_FLAG_WRITE).
+// Devuelve false si el rango no es válido o no queda espacio.
+bool debug_add_watch(chip8_debugger_t *dbg, uint16_t first, uint16_t last, uint8_t flags);
+
+// Quita los watchpoints cuyo rango contiene addr. Devuelve false si no había ninguno.
+bool debug_remove_watch(chip8_debugger_t *dbg, uint16_t addr);
+
+// Interpretan la línea de comandos:
+//   breakpoint: "2A4" o "2A4:V3==10" / "2A4:I>=300" (valores en hexadecimal)
+//   watchpoint: "300" o "300-30F"
+// Solo admiten dígitos hexadecimales (con "0x" opcional): sin espacios ni signos,
+// direcciones menores que RAM_SIZE y valores que quepan en el registro.
+bool debug_parse_break(chip8_debugger_t *dbg, const char *text);
+bool debug_parse_watch(chip8_debugger_t *dbg, const char *text, uint8_t flags);
+
+// Ejecuta hasta 'cycles' instrucciones o hasta que salte un punto.
+// Devuelve el número de instrucciones ejecutadas; dbg->stop indica si se detuvo.
+int debug_run(chip8_debugger_t *dbg, int cycles);
+
+// Limpia la parada actual para seguir ejecutando
+void debug_continue(chip8_debugger_t *dbg);
+
+// Ejecuta exactamente una instrucción, aunque haya un breakpoint en el PC
+void debug_step(chip8_debugger_t *dbg);
+
+// Describe la parada actual en texto (para el overlay)
+void debug_describe_stop(const chip8_debugger_t *dbg, char *buffer, size_t size);
+
+// Llamada por el núcleo en cada acceso a memoria[addr .. addr + length - 1]
+// mientras chip8->watch no es NULL. access es DEBUG_FLAG_READ o DEBUG_FLAG_WRITE.
+void chip8_debug_access(chip8_debugger_t *dbg, uint16_t addr, int length, uint8_t access);
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// --- MEDIDAS DE RENDIMIENTO ---
+// Contadores del overlay de rendimiento (F3) y del CSV de pruebas largas.
+// No depende de Raylib: quien llama pasa los instantes en segundos (GetTime()).
+// Cada segundo se cierra una ventana con sus estadísticas (perf_report_t),
+// que es lo que se muestra en pantalla y lo que se escribe en el CSV.
+
+// Frames recientes que se guardan para calcular percentiles (10 s a 60Hz)
+#define PERF_HISTORY 600
+
+// Histograma de duración de frame: cubos de 1 ms, el último acumula el resto
+#define PERF_HISTOGRAM_BINS 40
+
+// Un frame cuenta como perdido si dura más de 1.5 veces lo previsto
+#define PERF_DROP_FACTOR 1.5
+
+// Partes del frame que se miden por separado
+typedef enum {
+    PERF_CPU,       // Ciclos de la CPU emulada (y escalado en modo mosaico)
+    PERF_DRAW,      // Escalado, subida de textura y dibujo (sin la espera del vsync)
+    PERF_AUDIO,     // Generación y envío del beeper
+    PERF_SECTION_COUNT
+} perf_section_t;
+
+// Resumen de una ventana de un segundo
+typedef struct {
+    double time;                            // Segundos desde el primer frame
+    double fps;
+    double ips;                             // Instrucciones emuladas por segundo
+    double frame_p50, frame_p99;            // ms, sobre los últimos PERF_HISTORY frames
+    double frame_max;                       // ms, el peor frame de esta ventana
+    double section_ms[PERF_SECTION_COUNT];  // Media por frame en esta ventana
+    uint32_t dropped;                       // Frames perdidos en esta ventana
+    uint32_t underruns;                     // Vaciados del audio en esta ventana
+    uint64_t total_dropped;
+    uint64_t total_underruns;
+} perf_report_t;
+
+typedef struct {
+    double target_frame;        // Duración prevista de un frame (s)
+    double start;               // Instante del primer perf_frame
+    double frame_start;         // Inicio del frame en curso
+    bool started;               // Ya ha empezado el primer frame
+    double section_start[PERF_SECTION_COUNT];
+    double section[PERF_SECTION_COUNT];     // Acumulado del frame en curso (s)
+
+    // Últimos frames (anillo) y su histograma, actualizado frame a frame
+    float frame_ms[PERF_HISTORY];
+    int history_count;
+    int history_next;
+    uint32_t histogram[PERF_HISTOGRAM_BINS];
+
+    // Ventana de un segundo en curso
+    double window_start;
+    uint32_t window_frames;
+    float window_max;           // ms
+    uint64_t window_instructions;
+    double window_section[PERF_SECTION_COUNT];
+    uint32_t window_dropped;
+    uint32_t window_underruns;
+
+    // Audio: hasta cuándo dura lo que ya se ha enviado al stream
+    double audio_buffer_time;   // Segundos que dura un bloque de audio
+    double audio_deadline;      // -1 hasta el primer bloque desde que empieza a sonar
+    bool audio_active;
+
+    uint64_t total_dropped;
+    uint64_t total_underruns;
+
+    perf_report_t report;       // Última ventana cerrada
+    FILE *csv;                  // Opcional: una fila por ventana
+} perf_t;
+
+// Prepara los contadores. audio_buffer_time = muestras por bloque / frecuencia.
+// La medida empieza con el primer perf_frame().
+void perf_init(perf_t *perf, double target_fps, double audio_buffer_time);
+
+// Abre el CSV y escribe la cabecera (cierra antes el anterior, si lo había).
+// Devuelve false si no se puede crear.
+bool perf_open_csv(perf_t *perf, const char *path);
+
+// Marca el inicio de un frame (y el final del anterior).
+// Devuelve true si se acaba de cerrar una ventana (hay un report nuevo).
+bool perf_frame(perf_t *perf, double now);
+
+// Delimitan una parte del frame
+void perf_begin(perf_t *perf, perf_section_t section, double now);
+void perf_end(perf_t *perf, perf_section_t section, double now);
+
+// Instrucciones emuladas en este frame
+void perf_instructions(perf_t *perf, uint64_t count);
+
+// Estado del beeper en este frame: si suena y si se ha enviado un bloque.
+// Un vaciado es un bloque que llega cuando el anterior ya se había agotado.
+void perf_audio(perf_t *perf, bool active, bool refilled, double now);
+
+// Escribe el último report en texto (varias líneas) para el overlay
+void perf_format(const perf_t *perf, char *buffer, size_t size);
+
+// Cierra el CSV
+void perf_close(perf_t *perf);
+
+#endif
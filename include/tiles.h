@@ -0,0 +1,78 @@
+#ifndef TILES_H
+#define TILES_H
+
+#include <pthread.h>
+#include "chip8.h"
+#include "upscale.h"
+
+// --- MODO MOSAICO ---
+// Varias máquinas CHIP-8 en un solo proceso. Cada frame, un grupo de hilos
+// ejecuta los ciclos de cada máquina y escala su pantalla directamente en
+// su región del atlas (un buffer RGBA compartido que se sube como una única
+// textura). No depende de Raylib: main.c se encarga de ventana, teclado y audio.
+
+// Una sesión: máquina, fósforo del modo CRT (lo único del escalador que es
+// de cada sesión) y la región del atlas donde se dibuja.
+typedef struct {
+    chip8_t chip8;
+    uint8_t phosphor[SCREEN_WIDTH * SCREEN_HEIGHT];
+    const char *rom;
+    int x, y;               // Esquina superior izquierda en el atlas
+    int width, height;      // Tamaño de la región en píxeles
+
+    // Hash de la pantalla ya escalada en el atlas (para no repetir trabajo)
+    uint64_t drawn_hash;
+    bool drawn;
+
+    // Tipos de fallo (CHIP8_FAULT_*) ya avisados por consola
+    uint8_t reported_faults;
+} tile_t;
+
+typedef struct {
+    tile_t *tiles;
+    int count;
+    int columns, rows;
+
+    // Atlas de destino (propiedad de quien llama)
+    uint32_t *atlas;
+    int atlas_width, atlas_height;
+
+    int cycles_per_frame;
+    upscale_filter_t filter;
+
+    // Grupo de hilos: cada frame se reparten las sesiones con un contador atómico.
+    // Cada hilo dibuja con su propio escalador (la rejilla es memoria de trabajo).
+    pthread_t *threads;
+    upscaler_t *upscalers;
+    int thread_count;
+    volatile int started;       // Hilos arrancados (el orden da su escalador)
+    pthread_mutex_t lock;
+    pthread_cond_t start;       // Hay un frame nuevo que ejecutar
+    pthread_cond_t done;        // Todas las sesiones terminaron el frame
+    unsigned frame;             // Número de frame (los hilos esperan a que cambie)
+    volatile int next_tile;     // Siguiente sesión libre en este frame
+    int finished;               // Sesiones terminadas en este frame
+    int redrawn;                // Sesiones que redibujaron su región en este frame
+    bool quit;
+} tiles_t;
+
+// Carga las ROMs y reparte el atlas en una rejilla casi cuadrada.
+// threads <= 0 usa un hilo por núcleo (sin pasar del número de sesiones).
+// Si falla, ya lo ha liberado todo (no hace falta llamar a tiles_shutdown).
+bool tiles_init(tiles_t *t, const char **roms, int count, uint32_t *atlas,
+                int atlas_width, int atlas_height, int cycles_per_frame, int threads);
+
+// Ejecuta un frame en todas las sesiones (ciclos + timers + escalado) y espera.
+// Devuelve cuántas sesiones cambiaron su región del atlas.
+int tiles_step(tiles_t *t);
+
+// Cambia el filtro de escalado de todas las sesiones
+void tiles_set_filter(tiles_t *t, upscale_filter_t filter);
+
+// Sesión que ocupa el píxel (x, y) del atlas, o -1
+int tiles_hit(const tiles_t *t, int x, int y);
+
+// Detiene los hilos y libera la memoria
+void tiles_shutdown(tiles_t *t);
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef UPSCALE_H
+#define UPSCALE_H
+
+#include <stdint.h>
+
+// --- ESCALADO POR SOFTWARE ---
+// Convierte el buffer display[] del CHIP-8 (1 byte por píxel) en una imagen RGBA
+// del tamaño de la ventana, lista para subirla a una única textura por frame.
+// Todo se hace en CPU (sin shaders), usando SSE2 cuando está disponible.
+
+// Tamaño máximo del buffer de origen. Reservamos espacio para el modo
+// de alta resolución (128x64) aunque el núcleo actual sea de 64x32.
+#define UPSCALE_MAX_SRC_WIDTH 128
+#define UPSCALE_MAX_SRC_HEIGHT 64
+
+// Empaqueta un color en el orden de bytes R,G,B,A que espera la textura
+// (PIXELFORMAT_UNCOMPRESSED_R8G8B8A8). Asume una máquina little-endian.
+#define UPSCALE_RGBA(r, g, b, a) \
+    ((uint32_t)(r) | ((uint32_t)(g) << 8) | ((uint32_t)(b) << 16) | ((uint32_t)(a) << 24))
+
+// Filtros disponibles (se alternan con F2 en main.c)
+typedef enum {
+    UPSCALE_NEAREST,    // Píxeles cuadrados, sin suavizado (como antes)
+    UPSCALE_SCALE2X,    // Suavizado de bordes Scale2x (EPX)
+    UPSCALE_SCALE3X,    // Suavizado de bordes Scale3x (AdvMAME3x)
+    UPSCALE_CRT,        // Líneas de barrido + persistencia del fósforo
+    UPSCALE_FILTER_COUNT
+} upscale_filter_t;
+
+// Filtro, paleta y memoria de trabajo. La rejilla solo se usa dentro de
+// upscale_frame(), así que basta un escalador por hilo que dibuja aunque
+// haya varias pantallas. Lo que sí es de cada pantalla (el fósforo del
+// modo CRT) lo guarda quien llama y se pasa en cada frame.
+typedef struct {
+    upscale_filter_t filter;
+
+    // Paleta de 256 niveles de intensidad, interpolada entre el color
+    // de fondo (0) y el color de píxel encendido (255).
+    uint32_t palette[256];
+
+    // Rejilla intermedia (hasta 3x el origen) donde se aplica el filtro
+    // antes de expandirla al tamaño final.
+    uint8_t grid[UPSCALE_MAX_SRC_WIDTH * 3 * UPSCALE_MAX_SRC_HEIGHT * 3];
+} upscaler_t;
+
+// Inicializa el escalador con los colores de píxel encendido y apagado
+void upscale_init(upscaler_t *up, uint32_t on_color, uint32_t off_color);
+
+// Escala el buffer src (sw x sh, 1 = encendido) hacia dst (dw x dh píxeles RGBA).
+// pitch es el ancho de una fila de dst en píxeles (>= dw), lo que permite
+// escribir dentro de una región de una textura más grande.
+// phosphor (sw x sh bytes, a 0 al empezar) es la intensidad de cada píxel en
+// el modo CRT: decae un poco en cada frame para simular la persistencia del
+// fósforo. Solo se usa en ese modo.
+void upscale_frame(upscaler_t *up, uint8_t *phosphor, const uint8_t *src, int sw, int sh,
+                   uint32_t *dst, int dw, int dh, int pitch);
+
+// Nombre legible del filtro (para mostrarlo en pantalla)
+const char *upscale_filter_name(upscale_filter_t filter);
+
+#endif
@@ -0,0 +1,126 @@
+#include "aot.h"
+#include <stdio.h>
+#include <dlfcn.h>      // Para dlopen, dlsym, dlclose
+
+// Carga un módulo .so generado por tools/aot
+bool chip8_aot_load(chip8_aot_t *aot, const char *path) {
+    memset(aot, 0, sizeof(*aot));
+
+    // Sin '/', dlopen buscaría en las rutas de bibliotecas del sistema
+    // en lugar del directorio actual
+    char local_path[1024];
+    if (!strchr(path, '/')) {
+        snprintf(local_path, sizeof(local_path), "./%s", path);
+        path = local_path;
+    }
+
+    aot->handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!aot->handle) {
+        fprintf(stderr, "Error: No se pudo cargar %s: %s\n", path, dlerror());
+        return false;
+    }
+
+    // El módulo exporta una variable (no una función), así que el puntero
+    // de dlsym se puede convertir directamente sin salirnos de C99.
+    const chip8_aot_module_t *module = dlsym(aot->handle, CHIP8_AOT_SYMBOL);
+    if (!module) {
+        fprintf(stderr, "Error: %s no es un módulo AOT (%s)\n", path, dlerror());
+        chip8_aot_unload(aot);
+        return false;
+    }
+    // Con otra ABI el resto de la estructura puede ser distinto: se mira primero
+    static const uint32_t offsets[CHIP8_AOT_FIELD_COUNT] = CHIP8_AOT_OFFSETS;
+    if (module->abi != CHIP8_AOT_ABI || module->state_size != sizeof(chip8_t) ||
+        memcmp(module->offsets, offsets, sizeof(offsets)) != 0) {
+        fprintf(stderr, "Error: %s se generó con otra versión del emulador\n", path);
+        chip8_aot_unload(aot);
+        return false;
+    }
+
+    module->bind(chip8_execute);
+
+    for (int i = 0; i < module->block_count; i++) {
+        const chip8_aot_block_t *block = &module->blocks[i];
+        if (block->addr + block->length <= RAM_SIZE) {
+            aot->table[block->addr] = block;
+            memset(&aot->code[block->addr], true, block->length);
+            if (block->length > aot->max_length) {
+                aot->max_length = block->length;
+            }
+        }
+    }
+    aot->module = module;
+    return true;
+}
+
+// El programa escribió en [start, end): los bloques que se solapan con ese
+// rango se vuelven a comparar con sus bytes originales antes de ejecutarse.
+// Las escrituras en datos (lo habitual) no tocan ningún bloque.
+static void chip8_aot_written(chip8_aot_t *aot, int start, int end) {
+    int a = start;
+    while (a < end && !aot->code[a]) {
+        a++;
+    }
+    if (a == end) {
+        return;
+    }
+
+    // Un bloque que empiece hasta max_length - 1 bytes antes puede llegar a start
+    int first = start - aot->max_length + 1;
+    for (a = (first > 0) ? first : 0; a < end; a++) {
+        const chip8_aot_block_t *block = aot->table[a];
+        if (block && a + block->length > start) {
+            aot->ready[a] = NULL;
+        }
+    }
+}
+
+// Ejecuta exactamente 'cycles' instrucciones, con código nativo cuando es posible
+void chip8_aot_run(chip8_aot_t *aot, chip8_t *chip8, int cycles) {
+    while (cycles > 0) {
+        // Escrituras del último bloque o instrucción (FX33/FX55). Un bloque que
+        // pisa su propio código sale en ese momento, así que todas se ven aquí
+        // antes de volver a entrar en código traducido.
+        if (chip8->written_start != chip8->written_end) {
+            chip8_aot_written(aot, chip8->written_start, chip8->written_end);
+            chip8->written_start = chip8->written_end = 0;
+        }
+
+        if (chip8->pc >= RAM_SIZE) {
+            chip8_cycle(chip8);         // El intérprete registra el fallo
+            cycles--;
+            continue;
+        }
+
+        // Camino rápido: bloque ya comprobado
+        const chip8_aot_block_t *block = aot->ready[chip8->pc];
+        if (block) {
+            cycles -= block->run(chip8, cycles);
+            continue;
+        }
+
+        block = aot->table[chip8->pc];
+        if (block) {
+            // Primera entrada, o una escritura lo tocó: comparamos con los bytes
+            // originales. Si el programa ha sobreescrito su propio código, el bloque
+            // ya no vale: lo descartamos para siempre y seguimos con el intérprete.
+            if (memcmp(&chip8->memory[block->addr], block->code, block->length) == 0) {
+                aot->ready[chip8->pc] = block;
+                cycles -= block->run(chip8, cycles);
+                continue;
+            }
+            aot->table[chip8->pc] = NULL;
+        }
+
+        chip8_cycle(chip8);
+        cycles--;
+    }
+}
+
+// Descarga el módulo
+void chip8_aot_unload(chip8_aot_t *aot) {
+    if (aot->handle) {
+        dlclose(aot->handle);
+    }
+    memset(aot, 0, sizeof(*aot));
+}
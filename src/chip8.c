@@ -1,6 +1,6 @@
 #include "chip8.h"
 #include "debug.h"
-#include <stdio.h> // Para printf (útil para debug si una instrucción falla)
+#include <stdio.h> // Para fopen y los mensajes de error al cargar la ROM
 
 // Los sprites de los caracteres hexadecimales (0-F).
 // Cada byte representa una fila de 8 píxeles.
@@ -30,6 +30,55 @@ const uint8_t fontset[80] = {
     0xF0, 0x80, 0xF0, 0x80, 0x80    // F
 };
 
+// Semilla fija del generador de CXNN: la misma ROM con las mismas teclas
+// produce siempre la misma partida (útil para depurar y reproducir fallos).
+#define RNG_SEED 0x2545F491u
+
+// Registra un fallo de ejecución (ver CHIP8_FAULT_* en chip8.h).
+// El PC ya apunta a la siguiente instrucción, así que la culpable está en pc - 2.
+static void chip8_fault(chip8_t *chip8, uint8_t fault, uint16_t opcode) {
+    chip8->fault |= fault;
+    chip8->fault_opcode = opcode;
+    chip8->fault_pc = chip8->pc - 2;
+}
+
+// Amplía el rango de RAM escrito por el programa con [addr, addr + length)
+static void chip8_mark_written(chip8_t *chip8, uint16_t addr, uint16_t length) {
+    uint16_t end = addr + length;
+    if (chip8->written_start == chip8->written_end) {
+        chip8->written_start = addr;
+        chip8->written_end = end;
+        return;
+    }
+    if (addr < chip8->written_start) {
+        chip8->written_start = addr;
+    }
+    if (end > chip8->written_end) {
+        chip8->written_end = end;
+    }
+}
+
+// Clave Zobrist de un píxel: un número aleatorio fijo de 64 bits por posición.
+// El hash de la pantalla es el XOR de las claves de los píxeles encendidos,
+// así que encender o apagar un píxel es un único XOR con su clave.
+// Se calcula al vuelo (mezcla de splitmix64) para no necesitar una tabla global.
+static inline uint64_t zobrist_key(int index) {
+    uint64_t z = (uint64_t)(index + 1) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Generador xorshift32: rápido y con estado propio en cada máquina
+static uint8_t chip8_random(chip8_t *chip8) {
+    uint32_t r = chip8->rng_state;
+    r ^= r << 13;
+    r ^= r >> 17;
+    r ^= r << 5;
+    chip8->rng_state = r;
+    return r >> 24;
+}
+
 // Inicializa o reinicia la máquina CHIP-8
 void chip8_init(chip8_t *chip8) {
     // 1. Limpiamos toda la memoria y registros
@@ -39,12 +88,22 @@ void chip8_init(chip8_t *chip8) {
     chip8->sp = 0;
     chip8->delay_timer = 0;
     chip8->sound_timer = 0;
+    chip8->draw_flag = false;
+    chip8->rng_state = RNG_SEED;
+    chip8->written_start = 0;
+    chip8->written_end = 0;
+    chip8->fault = 0;
+    chip8->fault_opcode = 0;
+    chip8->fault_pc = 0;
+    chip8->watch = NULL;
+    chip8->display_hash = 0;    // Pantalla vacía
 
     // Limpiamos (ponemos a 0) arrays completos
     memset(chip8->memory, 0, sizeof(chip8->memory));
     memset(chip8->V, 0, sizeof(chip8->V));
     memset(chip8->stack, 0, sizeof(chip8->stack));
     memset(chip8->display, 0, sizeof(chip8->display));
+    memset(chip8->keypad, 0, sizeof(chip8->keypad));
 
     // 2. Cargamos el fontset en la memoria
     //    Lo copiamos desde nuestro array 'const' hacia la RAM de la máquina
@@ -53,8 +112,7 @@ void chip8_init(chip8_t *chip8) {
         chip8->memory[FONTSET_START_ADDRESS + i] = fontset[i];
     }
 
-    // Inicializamos la semilla aleatoria (necesario para la instrucción RND)
-    // Nota: srand se suele llamar una sola vez en el main, pero lo mencionamos aquí.
+    // La semilla aleatoria (instrucción RND) ya se fijó arriba en rng_state.
 }
 
 // Ejecuta un cicle de CPU (una instrucción)
@@ -64,6 +122,14 @@ void chip8_cycle(chip8_t *chip8) {
     // -------------------------------
     // Recuperamos el opcode de 16 bits combinando dos bytes de memoria.
     // pc: byte alto (high byte). pc+1 byte bajo (low byte).
+    // Si un salto o un skip ha dejado el PC fuera de la RAM, no leemos basura:
+    // registramos el fallo y la máquina se queda detenida en esa dirección.
+    if (chip8->pc > RAM_SIZE - 2) {
+        chip8->fault |= CHIP8_FAULT_PC_RANGE;
+        chip8->fault_opcode = 0;
+        chip8->fault_pc = chip8->pc;
+        return;
+    }
     uint16_t opcode = (chip8->memory[chip8->pc] << 8) | chip8->memory[chip8->pc + 1];
 
     // Avanzamos el Program Counter para la próxima instrucción.
@@ -71,6 +137,18 @@ void chip8_cycle(chip8_t *chip8) {
     // ya que un Jump sobreescribe el PC. Si sumamos 2 después del Jump, aterrizaremos mal.
     chip8->pc += 2;
 
+    // DEBUG
+#ifdef DEBUG
+    chip8_debug_print(chip8);
+#endif
+
+    chip8_execute(chip8, opcode);
+}
+
+// Decodifica y ejecuta un opcode. El PC ya debe apuntar a la instrucción siguiente.
+// Está separada de chip8_cycle para que el código traducido (ver aot.h) pueda
+// delegar en el intérprete las instrucciones que no genera en línea.
+void chip8_execute(chip8_t *chip8, uint16_t opcode) {
     // -------------------------------
     // 2. DECODE & EXECUTE 
     // -------------------------------
@@ -96,11 +174,6 @@ void chip8_cycle(chip8_t *chip8) {
     // Usamos el primer nibble (4 bits más altos) para categorizar la instrucción.
     // Aplicamos una máscara AND con 0xF000.
 
-    // DEBUG
-#ifdef DEBUG
-    chip8_debug_print(chip8);
-#endif
-
     switch (opcode & 0xF000) {
 
         case 0x0000:
@@ -108,6 +181,7 @@ void chip8_cycle(chip8_t *chip8) {
                 case 0x00E0:
                     // 00E0 - CLS (Clear Screen)
                     memset(chip8->display, 0, sizeof(chip8->display));
+                    chip8->display_hash = 0;
                     chip8->draw_flag = true;    // Avisar a Raylib que redibuje
                     break;
 
@@ -116,6 +190,8 @@ void chip8_cycle(chip8_t *chip8) {
                     if (chip8->sp > 0) { // Protección básica contra underflow
                         chip8->sp--;
                         chip8->pc = chip8->stack[chip8->sp];
+                    } else {
+                        chip8_fault(chip8, CHIP8_FAULT_STACK_UNDERFLOW, opcode);
                     }
                     break;
 
@@ -136,6 +212,8 @@ void chip8_cycle(chip8_t *chip8) {
                 chip8->stack[chip8->sp] = chip8->pc;
                 chip8->sp++;
                 chip8->pc = nnn;
+            } else {
+                chip8_fault(chip8, CHIP8_FAULT_STACK_OVERFLOW, opcode);
             }
             break;
         
@@ -261,7 +339,7 @@ void chip8_cycle(chip8_t *chip8) {
 
         case 0xC000:
             // CxNN - RND Vx, NN
-            chip8->V[x] = (rand() % 256) & nn;
+            chip8->V[x] = chip8_random(chip8) & nn;
             break;
         
         // DXYN - DRW Vx, Vy, nibble (Dibuja sprite)
@@ -277,9 +355,20 @@ void chip8_cycle(chip8_t *chip8) {
             //    Solo se pondrá a 1 si detectamos que apagamos un píxel.
             chip8->V[0xF] = 0;
 
+            // Watchpoints de lectura sobre los bytes del sprite
+            if (chip8->watch) {
+                chip8_debug_access(chip8->watch, chip8->I, height, DEBUG_FLAG_READ);
+            }
+
             // 3. Bucle para cada FILA del sprite (altura)
             for (int row = 0; row < height; row++) {
 
+                // El sprite no puede leerse más allá del final de la RAM
+                if (chip8->I + row >= RAM_SIZE) {
+                    chip8_fault(chip8, CHIP8_FAULT_I_RANGE, opcode);
+                    break;
+                }
+
                 // Obtenemos el byte de datos del sprite desde la memoria.
                 // La dirección es I + la fila actual.
                 uint8_t sprite_byte = chip8->memory[chip8->I + row];
@@ -320,6 +409,7 @@ void chip8_cycle(chip8_t *chip8) {
                         // -- DIBUJADO (XOR) --
                         // Aplicamos XOR al píxel de la pantalla.
                         chip8->display[screen_index] ^= 1;
+                        chip8->display_hash ^= zobrist_key(screen_index);
                     }
                 }
             }
@@ -333,9 +423,14 @@ void chip8_cycle(chip8_t *chip8) {
             switch (nn) {
                 // Ex9E - SKP Vx
                 // Salta la siguiente instrucción si la tecla guardada en Vx está presionada.
+                // Solo hay 16 teclas: con Vx > 0xF se registra el fallo y, como
+                // el COSMAC VIP original, se usa solo el nibble bajo.
                 case 0x9E:{
                     uint8_t key = chip8->V[x];  // ¿Qué tecla queremos revisar? (0-F)
-                    if (chip8->keypad[key]) {
+                    if (key >= NUM_KEYS) {
+                        chip8_fault(chip8, CHIP8_FAULT_KEY_RANGE, opcode);
+                    }
+                    if (chip8->keypad[key & 0xF]) {
                         chip8->pc += 2;
                     }
                 }
@@ -344,15 +439,18 @@ void chip8_cycle(chip8_t *chip8) {
                 //ExA1 - SKNP Vx
                 // Salta la siguiente instrucción si la tecla guardada en Vx NO está presionada.
                 case 0xA1: {
-                    uint16_t key = chip8->V[x];
-                    if (!chip8->keypad[key]) {
+                    uint8_t key = chip8->V[x];
+                    if (key >= NUM_KEYS) {
+                        chip8_fault(chip8, CHIP8_FAULT_KEY_RANGE, opcode);
+                    }
+                    if (!chip8->keypad[key & 0xF]) {
                         chip8->pc += 2;
                     }
                 }
                 break;
 
                 default:
-                    printf("Opcode desconocido en 0xE...: %X\n", opcode);
+                    chip8_fault(chip8, CHIP8_FAULT_UNKNOWN_OPCODE, opcode);
                     break;
             }
             break;
@@ -419,35 +517,59 @@ void chip8_cycle(chip8_t *chip8) {
                 // Toma el valor de Vx (ej: 253) y lo separa en centenas, decenas y unidades en la memoria.
                 // memory[I] = 2, memory[I+1] = 5, memory[I+2] = 3.
                 case 0x33:
+                    if (chip8->I + 2 >= RAM_SIZE) {
+                        chip8_fault(chip8, CHIP8_FAULT_I_RANGE, opcode);
+                        break;
+                    }
+                    if (chip8->watch) {
+                        chip8_debug_access(chip8->watch, chip8->I, 3, DEBUG_FLAG_WRITE);
+                    }
                     chip8->memory[chip8->I]     = chip8->V[x] / 100;
                     chip8->memory[chip8->I + 1] = (chip8->V[x] / 10) % 10;
                     chip8->memory[chip8->I + 2] = chip8->V[x] % 10;
+                    chip8_mark_written(chip8, chip8->I, 3);
                     break;
 
                 // Fx55 - LD [I], Vx
                 // Vuelca los registros V0 hasta Vx en la memoria, empezando en I.
                 case 0x55:
+                if (chip8->I + x >= RAM_SIZE) {
+                    chip8_fault(chip8, CHIP8_FAULT_I_RANGE, opcode);
+                    break;
+                }
+                if (chip8->watch) {
+                    chip8_debug_access(chip8->watch, chip8->I, x + 1, DEBUG_FLAG_WRITE);
+                }
                 for (int i = 0; i <= x; i++) {
                     chip8->memory[chip8->I + i] = chip8->V[i];
                 }
+                chip8_mark_written(chip8, chip8->I, x + 1);
                 break;
 
                 // Fx65 - LD Vx, [I]
                 // Recupera de la memoria los valores para V0 hasta Vx.
                 case 0x65:
+                if (chip8->I + x >= RAM_SIZE) {
+                    chip8_fault(chip8, CHIP8_FAULT_I_RANGE, opcode);
+                    break;
+                }
+                if (chip8->watch) {
+                    chip8_debug_access(chip8->watch, chip8->I, x + 1, DEBUG_FLAG_READ);
+                }
                 for (int i = 0; i <= x; i++) {
                     chip8->V[i] = chip8->memory[chip8->I + i];
                 }
                 break;
 
                 default:
-                    printf("Opcode desconocido: 0x%X\n", opcode);    
+                    chip8_fault(chip8, CHIP8_FAULT_UNKNOWN_OPCODE, opcode);
+                    break;
             }
             break;
 
         default:
             // Si llegamos aquí, encontramos un opcode desconocido.
-            printf("Opcode desconocido: 0x%X\n", opcode);
+            chip8_fault(chip8, CHIP8_FAULT_UNKNOWN_OPCODE, opcode);
             break;
     }
 }
@@ -497,3 +619,32 @@ bool chip8_load_rom(chip8_t *chip8, const char *filename) {
     fclose(rom);
     return true;
 }
+
+// Hash de la pantalla, mantenido de forma incremental por DXYN y 00E0
+uint64_t chip8_display_hash(const chip8_t *chip8) {
+    return chip8->display_hash;
+}
+
+// Hash de la pantalla recalculado píxel a píxel
+uint64_t chip8_display_hash_full(const chip8_t *chip8) {
+    uint64_t hash = 0;
+    for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; i++) {
+        if (chip8->display[i]) {
+            hash ^= zobrist_key(i);
+        }
+    }
+    return hash;
+}
+
+// Describe un bit de fallo (CHIP8_FAULT_*) en texto
+const char *chip8_fault_name(uint8_t fault) {
+    switch (fault) {
+        case CHIP8_FAULT_UNKNOWN_OPCODE:  return "Opcode desconocido";
+        case CHIP8_FAULT_STACK_OVERFLOW:  return "Desbordamiento de pila (CALL)";
+        case CHIP8_FAULT_STACK_UNDERFLOW: return "Pila vacía (RET)";
+        case CHIP8_FAULT_I_RANGE:         return "Acceso con I fuera de la RAM";
+        case CHIP8_FAULT_PC_RANGE:        return "PC fuera de la RAM";
+        case CHIP8_FAULT_KEY_RANGE:       return "Tecla fuera de rango (EX9E/EXA1)";
+        default:                          return "Fallo desconocido";
+    }
+}
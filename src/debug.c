@@ -1,5 +1,7 @@
 #include "debug.h"
 #include <stdio.h>
+#include <string.h>     // Para memset, strncmp
+#include <ctype.h>      // Para isxdigit, isdigit, tolower
 
 // Imprime el estado actual del PC, Opcode y algunos registros clave
 void chip8_debug_print(chip8_t *chip8) {
@@ -11,4 +13,322 @@ void chip8_debug_print(chip8_t *chip8) {
     // Imprime los primeros 4 registros V para no saturar
     printf("V0: %02X V1: %02X V2: %02X V3: %02X\n",
            chip8->V[0], chip8->V[1], chip8->V[2], chip8->V[3]);
-}
\ No newline at end of file
+}
+
+// --- BREAKPOINTS Y WATCHPOINTS ---
+
+// Prepara el depurador para la máquina indicada (sin puntos armados)
+void debug_init(chip8_debugger_t *dbg, chip8_t *chip8) {
+    memset(dbg, 0, sizeof(*dbg));
+    dbg->chip8 = chip8;
+    chip8->watch = NULL;
+}
+
+// Arma un breakpoint incondicional (si no lo estaba ya)
+static void set_break(chip8_debugger_t *dbg, uint16_t addr) {
+    if (!(dbg->flags[addr] & DEBUG_FLAG_BREAK)) {
+        dbg->flags[addr] |= DEBUG_FLAG_BREAK;
+        dbg->break_count++;
+    }
+}
+
+// Pone un breakpoint incondicional o quita todos los de la dirección
+bool debug_toggle_break(chip8_debugger_t *dbg, uint16_t addr) {
+    if (addr >= RAM_SIZE) {
+        return false;
+    }
+    if (!(dbg->flags[addr] & (DEBUG_FLAG_BREAK | DEBUG_FLAG_COND))) {
+        set_break(dbg, addr);
+        return true;
+    }
+
+    if (dbg->flags[addr] & DEBUG_FLAG_BREAK) {
+        dbg->break_count--;
+    }
+    // Los condicionales de esta dirección también se van
+    int kept = 0;
+    for (int i = 0; i < dbg->condition_count; i++) {
+        if (dbg->conditions[i].addr == addr) {
+            dbg->break_count--;
+        } else {
+            dbg->conditions[kept++] = dbg->conditions[i];
+        }
+    }
+    dbg->condition_count = kept;
+    dbg->flags[addr] &= ~(DEBUG_FLAG_BREAK | DEBUG_FLAG_COND);
+    return false;
+}
+
+// Añade un breakpoint condicional. Devuelve false si no queda espacio.
+bool debug_add_condition(chip8_debugger_t *dbg, uint16_t addr, uint8_t reg, char cmp, uint16_t value) {
+    if (addr >= RAM_SIZE || reg > DEBUG_REG_I || dbg->condition_count >= DEBUG_MAX_CONDITIONS) {
+        return false;
+    }
+    debug_condition_t *c = &dbg->conditions[dbg->condition_count++];
+    c->addr = addr;
+    c->reg = reg;
+    c->cmp = cmp;
+    c->value = value;
+
+    dbg->flags[addr] |= DEBUG_FLAG_COND;
+    dbg->break_count++;
+    return true;
+}
+
+// Marca en flags[] las direcciones de un watchpoint
+static void mark_watch(chip8_debugger_t *dbg, const debug_watch_t *w) {
+    for (int addr = w->first; addr <= w->last; addr++) {
+        dbg->flags[addr] |= w->flags;
+    }
+}
+
+// Vigila las direcciones [first, last]
+bool debug_add_watch(chip8_debugger_t *dbg, uint16_t first, uint16_t last, uint8_t flags) {
+    if (first > last || last >= RAM_SIZE || dbg->watch_count >= DEBUG_MAX_WATCHES) {
+        return false;
+    }
+    debug_watch_t *w = &dbg->watches[dbg->watch_count++];
+    w->first = first;
+    w->last = last;
+    w->flags = flags;
+    mark_watch(dbg, w);
+
+    // A partir de ahora el núcleo nos avisa de los accesos a través de I
+    dbg->chip8->watch = dbg;
+    return true;
+}
+
+// Quita los watchpoints que contienen addr
+bool debug_remove_watch(chip8_debugger_t *dbg, uint16_t addr) {
+    int kept = 0;
+    for (int i = 0; i < dbg->watch_count; i++) {
+        const debug_watch_t *w = &dbg->watches[i];
+        if (addr < w->first || addr > w->last) {
+            dbg->watches[kept++] = *w;
+        }
+    }
+    if (kept == dbg->watch_count) {
+        return false;
+    }
+    dbg->watch_count = kept;
+
+    // Los rangos pueden solaparse: rehacemos las banderas con los que quedan
+    for (int a = 0; a < RAM_SIZE; a++) {
+        dbg->flags[a] &= ~(DEBUG_FLAG_READ | DEBUG_FLAG_WRITE);
+    }
+    for (int i = 0; i < dbg->watch_count; i++) {
+        mark_watch(dbg, &dbg->watches[i]);
+    }
+
+    // Sin watchpoints, el núcleo deja de avisarnos (un único if por acceso)
+    if (dbg->watch_count == 0) {
+        dbg->chip8->watch = NULL;
+    }
+    return true;
+}
+
+// Comprueba los breakpoints condicionales de una dirección
+static bool condition_matches(const chip8_debugger_t *dbg, uint16_t addr) {
+    const chip8_t *chip8 = dbg->chip8;
+    for (int i = 0; i < dbg->condition_count; i++) {
+        const debug_condition_t *c = &dbg->conditions[i];
+        if (c->addr != addr) {
+            continue;
+        }
+        uint16_t reg = (c->reg == DEBUG_REG_I) ? chip8->I : chip8->V[c->reg];
+        bool match = false;
+        switch (c->cmp) {
+            case '=': match = reg == c->value; break;
+            case '!': match = reg != c->value; break;
+            case '<': match = reg <  c->value; break;
+            case '>': match = reg >  c->value; break;
+            case 'l': match = reg <= c->value; break;
+            case 'g': match = reg >= c->value; break;
+        }
+        if (match) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Ejecuta hasta 'cycles' instrucciones o hasta que salte un punto
+int debug_run(chip8_debugger_t *dbg, int cycles) {
+    chip8_t *chip8 = dbg->chip8;
+
+    // Camino rápido: sin breakpoints no miramos el PC en absoluto.
+    // (Los watchpoints los comprueba el propio núcleo a través de chip8->watch.)
+    if (dbg->break_count == 0) {
+        dbg->resuming = false;
+        for (int i = 0; i < cycles; i++) {
+            chip8_cycle(chip8);
+            if (dbg->stop != DEBUG_STOP_NONE) {
+                return i + 1;
+            }
+        }
+        return cycles;
+    }
+
+    for (int i = 0; i < cycles; i++) {
+        uint16_t pc = chip8->pc;
+        uint8_t flags = (pc < RAM_SIZE) ? dbg->flags[pc] : 0;
+
+        // Camino lento: solo si la dirección tiene algún breakpoint
+        if ((flags & (DEBUG_FLAG_BREAK | DEBUG_FLAG_COND)) && !dbg->resuming) {
+            if ((flags & DEBUG_FLAG_BREAK) || condition_matches(dbg, pc)) {
+                dbg->stop = DEBUG_STOP_BREAK;
+                dbg->stop_addr = pc;
+                dbg->stop_pc = pc;
+                return i;
+            }
+        }
+        dbg->resuming = false;
+
+        chip8_cycle(chip8);
+        if (dbg->stop != DEBUG_STOP_NONE) {
+            return i + 1;
+        }
+    }
+    return cycles;
+}
+
+// Limpia la parada actual para seguir ejecutando
+void debug_continue(chip8_debugger_t *dbg) {
+    // Si estamos parados en un breakpoint, la próxima instrucción es la suya:
+    // hay que ejecutarla una vez sin volver a detenerse.
+    dbg->resuming = (dbg->stop == DEBUG_STOP_BREAK);
+    dbg->stop = DEBUG_STOP_NONE;
+}
+
+// Ejecuta exactamente una instrucción, aunque haya un breakpoint en el PC
+void debug_step(chip8_debugger_t *dbg) {
+    dbg->stop = DEBUG_STOP_NONE;
+    dbg->resuming = false;
+    chip8_cycle(dbg->chip8);
+}
+
+// Describe la parada actual en texto (para el overlay)
+void debug_describe_stop(const chip8_debugger_t *dbg, char *buffer, size_t size) {
+    switch (dbg->stop) {
+        case DEBUG_STOP_BREAK:
+            snprintf(buffer, size, "BREAK en 0x%03X", dbg->stop_addr);
+            break;
+        case DEBUG_STOP_READ:
+            snprintf(buffer, size, "LECTURA 0x%03X (PC 0x%03X)", dbg->stop_addr, dbg->stop_pc);
+            break;
+        case DEBUG_STOP_WRITE:
+            snprintf(buffer, size, "ESCRITURA 0x%03X (PC 0x%03X)", dbg->stop_addr, dbg->stop_pc);
+            break;
+        default:
+            snprintf(buffer, size, "-");
+            break;
+    }
+}
+
+// Llamada por el núcleo en cada acceso a memoria a través de I
+void chip8_debug_access(chip8_debugger_t *dbg, uint16_t addr, int length, uint8_t access) {
+    for (int i = 0; i < length && addr + i < RAM_SIZE; i++) {
+        if (dbg->flags[addr + i] & access) {
+            dbg->stop = (access == DEBUG_FLAG_WRITE) ? DEBUG_STOP_WRITE : DEBUG_STOP_READ;
+            dbg->stop_addr = addr + i;
+            // El núcleo ya avanzó el PC: la instrucción está dos bytes atrás
+            dbg->stop_pc = dbg->chip8->pc - 2;
+            return;
+        }
+    }
+}
+
+// --- LÍNEA DE COMANDOS ---
+
+// Valor de un dígito hexadecimal ya comprobado con isxdigit
+static int hex_digit(char c) {
+    return isdigit((unsigned char)c) ? c - '0' : tolower((unsigned char)c) - 'a' + 10;
+}
+
+// Lee un número hexadecimal (con o sin "0x") menor que 'limit'. A diferencia
+// de strtoul, no admite espacios ni signos delante: tiene que empezar por un
+// dígito. Devuelve false si no hay número o si llega a 'limit'.
+static bool parse_hex(const char *text, const char **end, uint32_t limit, uint16_t *value) {
+    if (text[0] == '0' && (text[1] == 'x' || text[1] == 'X') && isxdigit((unsigned char)text[2])) {
+        text += 2;
+    }
+    if (!isxdigit((unsigned char)*text)) {
+        return false;
+    }
+    uint32_t v = 0;
+    for (; isxdigit((unsigned char)*text); text++) {
+        v = v * 16 + hex_digit(*text);
+        if (v >= limit) {
+            return false;       // Comprobado en cada dígito: no puede desbordar
+        }
+    }
+    *value = (uint16_t)v;
+    *end = text;
+    return true;
+}
+
+// "2A4" o "2A4:V3==10" / "2A4:I>=300"
+bool debug_parse_break(chip8_debugger_t *dbg, const char *text) {
+    const char *p;
+    uint16_t addr;
+    if (!parse_hex(text, &p, RAM_SIZE, &addr)) {
+        return false;
+    }
+
+    if (*p == '\0') {
+        set_break(dbg, addr);
+        return true;
+    }
+    if (*p++ != ':') {
+        return false;
+    }
+
+    // Registro: Vx o I
+    uint8_t reg;
+    if (*p == 'I' || *p == 'i') {
+        reg = DEBUG_REG_I;
+        p++;
+    } else if ((*p == 'V' || *p == 'v') && isxdigit((unsigned char)p[1])) {
+        reg = (uint8_t)hex_digit(p[1]);
+        p += 2;
+    } else {
+        return false;
+    }
+
+    // Comparación
+    char cmp;
+    if      (strncmp(p, "==", 2) == 0) { cmp = '='; p += 2; }
+    else if (strncmp(p, "!=", 2) == 0) { cmp = '!'; p += 2; }
+    else if (strncmp(p, "<=", 2) == 0) { cmp = 'l'; p += 2; }
+    else if (strncmp(p, ">=", 2) == 0) { cmp = 'g'; p += 2; }
+    else if (*p == '<')                { cmp = '<'; p += 1; }
+    else if (*p == '>')                { cmp = '>'; p += 1; }
+    else return false;
+
+    // Un valor que el registro no puede tener nunca es un error, no una condición imposible
+    uint16_t value;
+    uint32_t limit = (reg == DEBUG_REG_I) ? 0x10000 : 0x100;
+    if (!parse_hex(p, &p, limit, &value) || *p != '\0') {
+        return false;
+    }
+    return debug_add_condition(dbg, addr, reg, cmp, value);
+}
+
+// "300" o "300-30F"
+bool debug_parse_watch(chip8_debugger_t *dbg, const char *text, uint8_t flags) {
+    const char *p;
+    uint16_t first, last;
+    if (!parse_hex(text, &p, RAM_SIZE, &first)) {
+        return false;
+    }
+    last = first;
+    if (*p == '-') {
+        if (!parse_hex(p + 1, &p, RAM_SIZE, &last)) {
+            return false;
+        }
+    }
+    if (*p != '\0') {
+        return false;
+    }
+    return debug_add_watch(dbg, first, last, flags);
+}
@@ -3,6 +3,11 @@
 #include <stdlib.h>
 #include "raylib.h"
 #include "chip8.h"
+#include "debug.h"
+#include "upscale.h"
+#include "tiles.h"
+#include "aot.h"
+#include "perf.h"
 
 // --- CONFIGURACIÓN DE PANTALLA ---
 
@@ -19,6 +24,30 @@
 // 60 frames * 10 ciclos = 600 instrucciones por segundo.
 #define CYCLES_PER_FRAME 10
 
+// Configuración del beeper: 44100Hz, 16 bits, mono, bloques de 4096 muestras
+#define AUDIO_SAMPLE_RATE 44100
+#define AUDIO_BUFFER_SAMPLES 4096
+
+// Buffer RGBA del tamaño de la ventana. El escalador lo rellena en CPU
+// y se sube a la GPU como una única textura por frame.
+static uint32_t frame_pixels[WINDOW_WIDTH * WINDOW_HEIGHT];
+
+// Estado del escalador (filtro, paleta...) y fósforo del modo CRT
+static upscaler_t upscaler;
+static uint8_t phosphor[SCREEN_WIDTH * SCREEN_HEIGHT];
+
+// Breakpoints y watchpoints (vacío salvo que se pidan por línea de comandos o con 'B')
+static chip8_debugger_t debugger;
+
+// Módulo nativo de la ROM generado por tools/aot (opcional, opción -a)
+static chip8_aot_t aot;
+
+// Contadores de rendimiento (overlay con F3 y CSV opcional con -p).
+// El texto del overlay se regenera una vez por segundo, no en cada frame.
+static perf_t perf;
+static char perf_text[256] = "Midiendo...";
+static bool perf_mode = false;
+
 // Mapa de teclas: Índice del array = Valor Hexadecimal CHIP8-8
 // Valor del array = Código de tecla de Raylib
 const int KEYMAP[16] = {
@@ -40,19 +69,263 @@ const int KEYMAP[16] = {
     KEY_V,          // F
 };
 
-int main(int argc, char **argv) {
-    // 1. Verificación de argumentos
-    if (argc != 2) {
-        printf("Uso: %s <ruta_a_la_rom>\n", argv[0]);
+// Genera la onda senoidal del beeper.
+// volume (0..1) escala la amplitud (0 = silencio).
+// Devuelve true si se envió un bloque nuevo al stream.
+static bool update_beeper(AudioStream stream, float volume, float *sineIdx) {
+    static short data[AUDIO_BUFFER_SAMPLES];
+    const float frequency = 440.0f;     // 440Hz (Nota La)
+
+    if (volume > 0.0f) {
+        // Si el timer está activo, generamos datos de onda senoidal
+        if (IsAudioStreamProcessed(stream)) {
+            // Rellenamos el buffer con la onda matemática
+            for (int k = 0; k < AUDIO_BUFFER_SAMPLES; k++) {
+                data[k] = (short)(32000.0f * volume * sinf(2 * PI * frequency * *sineIdx / AUDIO_SAMPLE_RATE));
+                *sineIdx += 1.0f;
+            }
+
+            // Enviamos los datos a la tarjeta de sonido
+            UpdateAudioStream(stream, data, AUDIO_BUFFER_SAMPLES);
+            return true;
+        }
+    } else {
+        // Si el timer es 0, aseguramos silencio.
+        // Simplemente no actualizamos el stream con datos nuevos.
+        // Reiniciamos el índice de la onda para que no "cruja" al volver a empezar.
+        *sineIdx = 0.0f;
+    }
+    return false;
+}
+
+// Empieza un frame en los contadores de rendimiento y, cada segundo,
+// regenera el texto del overlay. F3 lo muestra u oculta.
+static void perf_next_frame(void) {
+    if (perf_frame(&perf, GetTime())) {
+        perf_format(&perf, perf_text, sizeof(perf_text));
+    }
+    if (IsKeyPressed(KEY_F3)) {
+        perf_mode = !perf_mode;
+    }
+}
+
+// Overlay de rendimiento (F3): resumen del último segundo e histograma
+// de la duración de los frames (1 ms por barra; en rojo, los frames perdidos)
+static void draw_perf_overlay(void) {
+    const int width = 260;
+    const int x = WINDOW_WIDTH - width;
+    const int bar_width = (width - 20) / PERF_HISTOGRAM_BINS;
+    const int base = 185;
+    const int max_height = 60;
+
+    DrawRectangle(x, 0, width, base + 20, Fade(BLACK, 0.8f));
+    DrawText(perf_text, x + 10, 10, 10, GREEN);
+
+    uint32_t peak = 1;
+    for (int i = 0; i < PERF_HISTOGRAM_BINS; i++) {
+        if (perf.histogram[i] > peak) {
+            peak = perf.histogram[i];
+        }
+    }
+
+    double drop_ms = perf.target_frame * PERF_DROP_FACTOR * 1000.0;
+    for (int i = 0; i < PERF_HISTOGRAM_BINS; i++) {
+        int height = (int)(perf.histogram[i] * max_height / peak);
+        if (height > 0) {
+            DrawRectangle(x + 10 + i * bar_width, base - height, bar_width - 1, height,
+                          (i >= drop_ms) ? RED : GREEN);
+        }
+    }
+    DrawText("0", x + 10, base + 5, 10, GRAY);
+    DrawText("40+ ms", x + width - 45, base + 5, 10, GRAY);
+}
+
+// Imprime los fallos pendientes de la CPU y los marca como atendidos.
+// Cada tipo de fallo se avisa una sola vez por máquina ('reported' guarda
+// los ya avisados): una ROM que se queda atascada en un fallo lo repite en
+// cada frame y llenaría la consola a 60 líneas por segundo.
+static void report_faults(chip8_t *chip8, uint8_t *reported, const char *rom) {
+    for (uint8_t bit = 1; bit != 0; bit <<= 1) {
+        if ((chip8->fault & bit) && !(*reported & bit)) {
+            if (rom) {
+                printf("[%s] ", rom);
+            }
+            printf("%s: 0x%04X en 0x%03X (no se volverá a avisar)\n", chip8_fault_name(bit),
+                   chip8->fault_opcode, chip8->fault_pc);
+        }
+    }
+    *reported |= chip8->fault;
+    chip8->fault = 0;
+}
+
+// --- MODO MOSAICO ---
+// Ejecuta varias ROMs en la misma ventana. Cada sesión se escala en su región
+// del atlas (frame_pixels) y todo se sube y dibuja como una sola textura.
+// El teclado solo llega a la sesión con el foco (Tab o clic para cambiarlo).
+static int run_tiled(const char **roms, int count) {
+    static tiles_t tiles;
+    if (!tiles_init(&tiles, roms, count, frame_pixels, WINDOW_WIDTH, WINDOW_HEIGHT,
+                    CYCLES_PER_FRAME, 0)) {
+        return 1;
+    }
+
+    InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Emulador CHIP-8 en C - Mosaico");
+
+    Image screen_image = GenImageColor(WINDOW_WIDTH, WINDOW_HEIGHT, BLACK);
+    Texture2D screen_texture = LoadTextureFromImage(screen_image);
+    UnloadImage(screen_image);
+
+    InitAudioDevice();
+    if (!IsAudioDeviceReady()) {
+        printf("Error: No se pudo inicializar el dispositivo de audio.\n");
+        tiles_shutdown(&tiles);
         return 1;
     }
 
-    // 2. Inicialización del Hardware Virtual
+    // Un único stream para todas las sesiones
+    SetAudioStreamBufferSizeDefault(AUDIO_BUFFER_SAMPLES);
+    AudioStream stream = LoadAudioStream(AUDIO_SAMPLE_RATE, 16, 1);
+    PlayAudioStream(stream);
+    float sineIdx = 0.0f;
+
+    int focus = 0;
+    upscale_filter_t filter = UPSCALE_NEAREST;
+    bool atlas_uploaded = false;
+
+    SetTargetFPS(60);
+
+    while (!WindowShouldClose()) {
+        perf_next_frame();
+
+        // --- FOCO ---
+        if (IsKeyPressed(KEY_TAB)) {
+            focus = (focus + 1) % count;
+        }
+        if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+            Vector2 mouse = GetMousePosition();
+            int hit = tiles_hit(&tiles, (int)mouse.x, (int)mouse.y);
+            if (hit >= 0) {
+                focus = hit;
+            }
+        }
+
+        if (IsKeyPressed(KEY_F2)) {
+            filter = (filter + 1) % UPSCALE_FILTER_COUNT;
+            tiles_set_filter(&tiles, filter);
+        }
+
+        // --- ENTRADA ---
+        // Solo la sesión con el foco ve el teclado; las demás lo ven suelto.
+        for (int t = 0; t < count; t++) {
+            for (int i = 0; i < 16; i++) {
+                tiles.tiles[t].chip8.keypad[i] = (t == focus) && IsKeyDown(KEYMAP[i]);
+            }
+        }
+
+        // --- CPU + ESCALADO (en paralelo) ---
+        // Devuelve cuántas sesiones redibujaron su región del atlas
+        perf_begin(&perf, PERF_CPU, GetTime());
+        int redrawn = tiles_step(&tiles);
+        perf_end(&perf, PERF_CPU, GetTime());
+        perf_instructions(&perf, (uint64_t)count * CYCLES_PER_FRAME);
+
+        // --- FALLOS ---
+        for (int t = 0; t < count; t++) {
+            tile_t *tile = &tiles.tiles[t];
+            if (tile->chip8.fault) {
+                report_faults(&tile->chip8, &tile->reported_faults, tile->rom);
+            }
+        }
+
+        // --- SONIDO ---
+        // Solo suena la sesión con el foco, igual que solo ella recibe el teclado.
+        // Todas las sesiones usan el mismo tono de 440Hz, así que mezclarlas no
+        // distingue quién pita: sumadas y recortadas, una o N voces suenan igual.
+        bool sounding = tiles.tiles[focus].chip8.sound_timer > 0;
+        perf_begin(&perf, PERF_AUDIO, GetTime());
+        bool refilled = update_beeper(stream, sounding ? 1.0f : 0.0f, &sineIdx);
+        perf_end(&perf, PERF_AUDIO, GetTime());
+        perf_audio(&perf, sounding, refilled, GetTime());
+
+        // --- RENDERIZADO ---
+        // Una subida (solo si alguna sesión cambió) y una llamada de dibujo para todo el atlas
+        perf_begin(&perf, PERF_DRAW, GetTime());
+        BeginDrawing();
+        ClearBackground(BLACK);
+        if (redrawn > 0 || !atlas_uploaded) {
+            UpdateTexture(screen_texture, frame_pixels);
+            atlas_uploaded = true;
+        }
+        DrawTexture(screen_texture, 0, 0, WHITE);
+
+        const tile_t *focused = &tiles.tiles[focus];
+        DrawRectangleLines(focused->x, focused->y, focused->width, focused->height, YELLOW);
+
+        if (perf_mode) {
+            draw_perf_overlay();
+        }
+        perf_end(&perf, PERF_DRAW, GetTime());     // EndDrawing incluye la espera del vsync
+        EndDrawing();
+    }
+
+    tiles_shutdown(&tiles);
+    UnloadTexture(screen_texture);
+    UnloadAudioStream(stream);
+    CloseAudioDevice();
+    CloseWindow();
+
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    // 1. Inicialización del Hardware Virtual
     chip8_t chip8;
     chip8_init(&chip8);
+    debug_init(&debugger, &chip8);
+
+    // 2. Verificación de argumentos: opciones de depuración y después la ROM
+    //   -b 2A4 / -b 2A4:V3==10   Breakpoint (condicional) en una dirección
+    //   -r 300-30F / -w 300      Watchpoint de lectura / escritura
+    //   -a rom.so                Código nativo generado con tools/aot
+    //   -p perf.csv              Contadores de rendimiento, una fila por segundo
+    perf_init(&perf, 60, (double)AUDIO_BUFFER_SAMPLES / AUDIO_SAMPLE_RATE);
+    int arg = 1;
+    for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2) {
+        bool ok = false;
+        switch (argv[arg][1]) {
+            case 'b': ok = debug_parse_break(&debugger, argv[arg + 1]); break;
+            case 'r': ok = debug_parse_watch(&debugger, argv[arg + 1], DEBUG_FLAG_READ); break;
+            case 'w': ok = debug_parse_watch(&debugger, argv[arg + 1], DEBUG_FLAG_WRITE); break;
+            case 'a': ok = chip8_aot_load(&aot, argv[arg + 1]); break;
+            case 'p': ok = perf_open_csv(&perf, argv[arg + 1]); break;
+        }
+        if (!ok) {
+            printf("Error: opción no válida %s %s\n", argv[arg], argv[arg + 1]);
+            return 1;
+        }
+    }
+    if (arg >= argc) {
+        printf("Uso: %s [-b dir[:Vx==nn]] [-r ini[-fin]] [-w ini[-fin]] [-a rom.so] [-p perf.csv] <ruta_a_la_rom> [más ROMs...]\n", argv[0]);
+        return 1;
+    }
+
+    // Con varias ROMs, todas se ejecutan a la vez en una sola ventana (modo mosaico)
+    if (argc - arg > 1) {
+        if (debugger.break_count > 0 || debugger.watch_count > 0) {
+            printf("Error: los breakpoints y watchpoints solo funcionan con una ROM\n");
+            return 1;
+        }
+        if (aot.module) {
+            printf("Error: el módulo AOT solo funciona con una ROM\n");
+            return 1;
+        }
+        int result = run_tiled((const char **)&argv[arg], argc - arg);
+        perf_close(&perf);
+        return result;
+    }
 
     // Intentamos cargar la ROM especificada
-    if (!chip8_load_rom(&chip8, argv[1])) {
+    if (!chip8_load_rom(&chip8, argv[arg])) {
         // El mensaje de error ya se imprime dentro de chip8_load_rom
         return 1;
     }
@@ -60,6 +333,13 @@ int main(int argc, char **argv) {
     // 3. Inicialización de Raylib (La Ventana)
     InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Emulador CHIP-8 en C");
 
+    // Textura donde subiremos la imagen escalada en cada frame
+    Image screen_image = GenImageColor(WINDOW_WIDTH, WINDOW_HEIGHT, BLACK);
+    Texture2D screen_texture = LoadTextureFromImage(screen_image);
+    UnloadImage(screen_image);
+
+    upscale_init(&upscaler, UPSCALE_RGBA(255, 255, 255, 255), UPSCALE_RGBA(0, 0, 0, 255));
+
     // 1. Inicializar Audio
     InitAudioDevice();
     if (!IsAudioDeviceReady()) {
@@ -68,18 +348,25 @@ int main(int argc, char **argv) {
     }
 
     // Configuración del stream de audio (44100Hz, 16bit, Mono)
-    SetAudioStreamBufferSizeDefault(4096);
-    AudioStream stream = LoadAudioStream(44100, 16, 1);
+    SetAudioStreamBufferSizeDefault(AUDIO_BUFFER_SAMPLES);
+    AudioStream stream = LoadAudioStream(AUDIO_SAMPLE_RATE, 16, 1);
     PlayAudioStream(stream);    // Empezamos el stream (aunque le enviaremos silencio por ahora)
 
-    // Variables para la generación de onda
-    float frequency = 440.0f;   // 440Hz (Nota La)
+    // Posición en la onda senoidal
     float sineIdx = 0.0f;
 
+    // Hash de la última pantalla escalada: si no cambia, no hace falta
+    // volver a escalar ni subir la textura.
+    uint64_t drawn_hash = 0;
+    bool frame_valid = false;
+
     // Control de modo pausa y debug
     bool debug_mode = false;    // Alternar con F1
     bool paused = false;        // Alternar con P
 
+    // Tipos de fallo ya avisados por consola (ver report_faults)
+    uint8_t reported_faults = 0;
+
     // Fijamos los FPS a 60. Esto es CRÍTICO.
     // Raylib intentará dormir el proceso para mantener esta velocidad estable.
     // Esto nos servirá como reloj maestro para los Timers del CHIP-8.
@@ -87,6 +374,7 @@ int main(int argc, char **argv) {
 
     // Bucle principal: Se ejecuta mientras no cerramos la ventana
     while (!WindowShouldClose()) {
+        perf_next_frame();
 
         // --- GESTIÓN DE ENTRADA ---
         // Actualizamos el estado del teclado virtual antes de que la CPU corra.
@@ -103,30 +391,72 @@ int main(int argc, char **argv) {
             debug_mode = !debug_mode;
         }
 
+        // Cambia el filtro de escalado (NEAREST -> SCALE2X -> SCALE3X -> CRT)
+        if (IsKeyPressed(KEY_F2)) {
+            upscaler.filter = (upscaler.filter + 1) % UPSCALE_FILTER_COUNT;
+            frame_valid = false;
+        }
+
         // Alterna entre modo Pause
         if (IsKeyPressed(KEY_P)) {
             paused = !paused;
+            if (!paused) {
+                debug_continue(&debugger);  // Reanudamos aunque estemos sobre un breakpoint
+            }
+        }
+
+        // En pausa, 'B' quita el watchpoint que acaba de saltar o, si no, pone
+        // o quita los breakpoints del PC actual (también los condicionales)
+        if (paused && IsKeyPressed(KEY_B)) {
+            bool on_watch = debugger.stop == DEBUG_STOP_READ || debugger.stop == DEBUG_STOP_WRITE;
+            if (on_watch && debug_remove_watch(&debugger, debugger.stop_addr)) {
+                printf("Watchpoint en 0x%03X eliminado\n", debugger.stop_addr);
+            } else {
+                bool enabled = debug_toggle_break(&debugger, chip8.pc);
+                printf("Breakpoint en 0x%03X %s\n", chip8.pc, enabled ? "activado" : "desactivado");
+            }
         }
 
         // --- A. SIMULACIÓN DE CPU ---
         // Ejecutamos varios ciclos de CPU por cada frame de vídeo.
         // Esto separa la velocidad de renderizado (60Hz) de la velocidad de procesamiento (~600Hz).
         if (!paused) {
-            // Ejecución normal a 600Hz (10 ciclos por frame)
-            for (int i = 0; i < CYCLES_PER_FRAME; i++) {
-                chip8_cycle(&chip8);
+            // Ejecución normal a 600Hz (10 ciclos por frame).
+            // Con un módulo AOT y sin puntos de depuración, usamos el código nativo;
+            // si no, debug_run (que sin breakpoints es el mismo bucle de chip8_cycle).
+            perf_begin(&perf, PERF_CPU, GetTime());
+            int executed = CYCLES_PER_FRAME;
+            if (aot.module && debugger.break_count == 0 && debugger.watch_count == 0) {
+                chip8_aot_run(&aot, &chip8, CYCLES_PER_FRAME);
+            } else {
+                executed = debug_run(&debugger, CYCLES_PER_FRAME);
+            }
+            perf_end(&perf, PERF_CPU, GetTime());
+            perf_instructions(&perf, executed);
+
+            // Si saltó un breakpoint o watchpoint, pausamos y mostramos el overlay
+            if (debugger.stop != DEBUG_STOP_NONE) {
+                paused = true;
+                debug_mode = true;
             }
         } else {
             // Estamos en PAUSA.
             // Solo avanzamos si el usuario presiona 'S' (Step)
             if (IsKeyPressed(KEY_S)) {
-                chip8_cycle(&chip8);
+                debug_step(&debugger);
+                perf_instructions(&perf, 1);
                 // Opcional: Imprimir en consola también para tener historial
                 chip8_debug_print(&chip8);
             }
         }
         
 
+        // Informamos de los fallos que el núcleo haya registrado en este frame
+        // (opcodes desconocidos, pila, accesos fuera de la RAM, teclas fuera de rango).
+        if (chip8.fault) {
+            report_faults(&chip8, &reported_faults, NULL);
+        }
+
         // --- B. ACTUALIZACIÓN DE TEMPORIZADORES ---
         // Los timers de CHIP-8 funcionan a 60Hz, igual que nuestro refresco de pantalla.
         // Por lo tanto, los actualizamos una vez por vuelta del bucle principal.
@@ -134,53 +464,30 @@ int main(int argc, char **argv) {
 
         // --- GESTIÓN DE SONIDO ---
 
-        if (chip8.sound_timer > 0) {
-            // Si el timer está activo, generamos datos de onda senoidal
-            if (IsAudioStreamProcessed(stream)) {
-                // Buffer temporal para enviar al stream
-                short *data = (short *)malloc(sizeof(short) * 4096);
-
-                // Rellenamos el buffer con la onda matemática
-                for (int k = 0; k < 4096; k++) {
-                    data[k] = (short)(32000.0f * sinf(2 * PI * frequency * sineIdx / 44100));
-                    sineIdx += 1.0f;
-                }
-
-                // Enviamos los datos a la tarjeta de sonido
-                UpdateAudioStream(stream, data, 4096);
-                free(data);
-            }
-        } else {
-            // Si el timer es 0, aseguramos silencio.
-            // Simplemente no actualizamos el stream con datos nuevos,
-            // o podríamos enviar ceros si quisiéramos limpiar el buffer explícitamente.
-            // Para simplificar, reiniciamos el índice de la onda para que no "cruja" al volver a empezar.
-            sineIdx = 0.0f;
-        }
+        perf_begin(&perf, PERF_AUDIO, GetTime());
+        bool refilled = update_beeper(stream, chip8.sound_timer > 0 ? 1.0f : 0.0f, &sineIdx);
+        perf_end(&perf, PERF_AUDIO, GetTime());
+        perf_audio(&perf, chip8.sound_timer > 0, refilled, GetTime());
+
         // --- C. RENDERIZADO (DIBUJO) ---
+        perf_begin(&perf, PERF_DRAW, GetTime());
         BeginDrawing();
 
         ClearBackground(BLACK); // Limpiamos el fondo (color negro)
 
-        // Solo redibujamos los rectángulos si es necesario,
-        // aunque Raylib es tan rápido que podríamos hacerlo siempre sin perder rendimiento.
-        // Recorremos el array display[] linealmente.
-        for (int y = 0; y < SCREEN_HEIGHT; y++) {
-            for (int x = 0; x < SCREEN_WIDTH; x++) {
-
-                // Calculamos el índice en el array 1D
-                int index = x + (y * SCREEN_WIDTH);
-
-                // Si el píxel está encendido (1)
-                if (chip8.display[index] != 0) {
-                    // Dibujamos un rectángulo escalado
-                    // Posición X: x original * escala
-                    // Posición Y: y original * escala
-                    // Tamaño: escala x escala
-                    DrawRectangle(x * SCALE_FACTOR, y * SCALE_FACTOR, SCALE_FACTOR, SCALE_FACTOR, WHITE);
-                }
-            }
+        // Escalamos display[] a la resolución de la ventana en CPU
+        // y subimos el resultado a la textura (una sola subida por frame).
+        // Si el hash de la pantalla no cambió, la textura ya está al día.
+        // El modo CRT se redibuja siempre porque el fósforo se apaga frame a frame.
+        uint64_t display_hash = chip8_display_hash(&chip8);
+        if (!frame_valid || display_hash != drawn_hash || upscaler.filter == UPSCALE_CRT) {
+            upscale_frame(&upscaler, phosphor, chip8.display, SCREEN_WIDTH, SCREEN_HEIGHT,
+                          frame_pixels, WINDOW_WIDTH, WINDOW_HEIGHT, WINDOW_WIDTH);
+            UpdateTexture(screen_texture, frame_pixels);
+            drawn_hash = display_hash;
+            frame_valid = true;
         }
+        DrawTexture(screen_texture, 0, 0, WHITE);
 
         // --- DIBUJADO DE DEBUG UI ---
         if (debug_mode) {
@@ -195,27 +502,53 @@ int main(int argc, char **argv) {
                 DrawText(buffer, 10, 30 + (i * 15), 10, WHITE);
             }
 
+            // El resto de líneas van una debajo de otra: cada una avanza 'y',
+            // así que las opcionales no se pisan con las demás
             char buffer[64];
+            int y = 280;
             sprintf(buffer, "PC: 0x%04X", chip8.pc);
-            DrawText(buffer, 10, 280, 10, YELLOW);
+            DrawText(buffer, 10, y, 10, YELLOW);
+            y += 20;
 
             sprintf(buffer, "I:  0x%04X", chip8.I);
-            DrawText(buffer, 10, 300, 10, YELLOW);
+            DrawText(buffer, 10, y, 10, YELLOW);
+            y += 20;
 
             sprintf(buffer, "SP: 0x%02X", chip8.sp);
-            DrawText(buffer, 10, 320, 10, YELLOW);
+            DrawText(buffer, 10, y, 10, YELLOW);
+            y += 20;
+
+            sprintf(buffer, "FILTRO: %s (F2)", upscale_filter_name(upscaler.filter));
+            DrawText(buffer, 10, y, 10, GRAY);
+            y += 20;
 
             if (paused) {
-                DrawText("- PAUSADO -", 10, 350, 10, RED);
-                DrawText("Presiona 'S' para Step", 10, 370, 10, GRAY);
+                DrawText("- PAUSADO -", 10, y, 10, RED);
+                y += 20;
+                DrawText("Presiona 'S' para Step", 10, y, 10, GRAY);
+                y += 15;
+                DrawText("'B' poner/quitar punto", 10, y, 10, GRAY);
+                y += 20;
+            }
+
+            if (debugger.stop != DEBUG_STOP_NONE) {
+                debug_describe_stop(&debugger, buffer, sizeof(buffer));
+                DrawText(buffer, 10, y, 10, ORANGE);
             }
         }
-        
+
+        if (perf_mode) {
+            draw_perf_overlay();
+        }
+        perf_end(&perf, PERF_DRAW, GetTime());     // EndDrawing incluye la espera del vsync
 
         EndDrawing();
     }
 
     // 4. Limpieza
+    perf_close(&perf);
+    chip8_aot_unload(&aot);
+    UnloadTexture(screen_texture);
     UnloadAudioStream(stream);
     CloseAudioDevice();
     CloseWindow();  // Cierra ventana y contexto OpenGL
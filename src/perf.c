@@ -0,0 +1,175 @@
+#include "perf.h"
+#include <string.h>
+#include <stdlib.h>     // Para qsort
+
+void perf_init(perf_t *perf, double target_fps, double audio_buffer_time) {
+    memset(perf, 0, sizeof(*perf));
+    perf->target_frame = 1.0 / target_fps;
+    perf->audio_buffer_time = audio_buffer_time;
+}
+
+bool perf_open_csv(perf_t *perf, const char *path) {
+    perf_close(perf);       // Con -p repetido, solo vale el último
+    perf->csv = fopen(path, "w");
+    if (!perf->csv) {
+        fprintf(stderr, "Error: No se pudo crear %s\n", path);
+        return false;
+    }
+    fprintf(perf->csv, "time_s,fps,ips,frame_p50_ms,frame_p99_ms,frame_max_ms,"
+                       "cpu_ms,draw_ms,audio_ms,dropped,underruns\n");
+    return true;
+}
+
+static int compare_float(const void *a, const void *b) {
+    float x = *(const float *)a;
+    float y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+static int histogram_bin(float ms) {
+    int bin = (int)ms;
+    return (bin < PERF_HISTOGRAM_BINS) ? bin : PERF_HISTOGRAM_BINS - 1;
+}
+
+// Cierra la ventana de un segundo: calcula el report y lo escribe en el CSV
+static void perf_close_window(perf_t *perf, double now) {
+    perf_report_t *r = &perf->report;
+    double elapsed = now - perf->window_start;
+    uint32_t frames = perf->window_frames;
+
+    r->time = now - perf->start;
+    r->fps = frames / elapsed;
+    r->ips = perf->window_instructions / elapsed;
+    r->frame_max = perf->window_max;
+    for (int s = 0; s < PERF_SECTION_COUNT; s++) {
+        r->section_ms[s] = frames ? perf->window_section[s] * 1000.0 / frames : 0.0;
+    }
+    r->dropped = perf->window_dropped;
+    r->underruns = perf->window_underruns;
+    r->total_dropped = perf->total_dropped;
+    r->total_underruns = perf->total_underruns;
+
+    // Percentiles: ordenamos una copia del historial (una vez por segundo)
+    static float sorted[PERF_HISTORY];
+    int count = perf->history_count;
+    memcpy(sorted, perf->frame_ms, sizeof(float) * count);
+    qsort(sorted, count, sizeof(float), compare_float);
+    r->frame_p50 = count ? sorted[(count - 1) * 50 / 100] : 0.0;
+    r->frame_p99 = count ? sorted[(count - 1) * 99 / 100] : 0.0;
+
+    // Una fila por segundo; flush para no perder datos si el proceso muere
+    if (perf->csv) {
+        fprintf(perf->csv, "%.3f,%.2f,%.0f,%.3f,%.3f,%.3f,%.4f,%.4f,%.4f,%u,%u\n",
+                r->time, r->fps, r->ips, r->frame_p50, r->frame_p99, r->frame_max,
+                r->section_ms[PERF_CPU], r->section_ms[PERF_DRAW], r->section_ms[PERF_AUDIO],
+                r->dropped, r->underruns);
+        fflush(perf->csv);
+    }
+
+    perf->window_start = now;
+    perf->window_frames = 0;
+    perf->window_max = 0.0f;
+    perf->window_instructions = 0;
+    memset(perf->window_section, 0, sizeof(perf->window_section));
+    perf->window_dropped = 0;
+    perf->window_underruns = 0;
+}
+
+// Marca el inicio de un frame (y el final del anterior)
+bool perf_frame(perf_t *perf, double now) {
+    // El primer frame no tiene anterior: solo empezamos a contar
+    if (!perf->started) {
+        perf->started = true;
+        perf->start = now;
+        perf->frame_start = now;
+        perf->window_start = now;
+        return false;
+    }
+
+    float ms = (float)((now - perf->frame_start) * 1000.0);
+    perf->frame_start = now;
+
+    // Anillo de historial: el frame más viejo sale del histograma
+    if (perf->history_count == PERF_HISTORY) {
+        perf->histogram[histogram_bin(perf->frame_ms[perf->history_next])]--;
+    } else {
+        perf->history_count++;
+    }
+    perf->frame_ms[perf->history_next] = ms;
+    perf->history_next = (perf->history_next + 1) % PERF_HISTORY;
+    perf->histogram[histogram_bin(ms)]++;
+
+    if (ms > perf->target_frame * PERF_DROP_FACTOR * 1000.0) {
+        perf->window_dropped++;
+        perf->total_dropped++;
+    }
+    if (ms > perf->window_max) {
+        perf->window_max = ms;
+    }
+    perf->window_frames++;
+    for (int s = 0; s < PERF_SECTION_COUNT; s++) {
+        perf->window_section[s] += perf->section[s];
+        perf->section[s] = 0.0;
+    }
+
+    if (now - perf->window_start >= 1.0) {
+        perf_close_window(perf, now);
+        return true;
+    }
+    return false;
+}
+
+void perf_begin(perf_t *perf, perf_section_t section, double now) {
+    perf->section_start[section] = now;
+}
+
+void perf_end(perf_t *perf, perf_section_t section, double now) {
+    perf->section[section] += now - perf->section_start[section];
+}
+
+void perf_instructions(perf_t *perf, uint64_t count) {
+    perf->window_instructions += count;
+}
+
+// Cada bloque enviado alarga el audio pendiente en audio_buffer_time.
+// Si un bloque llega después de que se agotara lo pendiente, el stream
+// se quedó sin datos (y sonó silencio) mientras el beeper estaba activo.
+void perf_audio(perf_t *perf, bool active, bool refilled, double now) {
+    if (active && !perf->audio_active) {
+        perf->audio_deadline = -1.0;    // Empieza a sonar: aún no se ha enviado nada
+    }
+    if (refilled) {
+        if (active && perf->audio_deadline >= 0.0 && now > perf->audio_deadline) {
+            perf->window_underruns++;
+            perf->total_underruns++;
+        }
+        if (perf->audio_deadline < now) {
+            perf->audio_deadline = now;
+        }
+        perf->audio_deadline += perf->audio_buffer_time;
+    }
+    perf->audio_active = active;
+}
+
+// Escribe el último report en texto (varias líneas) para el overlay
+void perf_format(const perf_t *perf, char *buffer, size_t size) {
+    const perf_report_t *r = &perf->report;
+    snprintf(buffer, size,
+             "FPS: %.1f   Instr/s: %.0f\n"
+             "Frame p50: %.2f ms  p99: %.2f ms\n"
+             "Peor frame: %.2f ms\n"
+             "CPU: %.3f  Dibujo: %.3f  Audio: %.3f ms\n"
+             "Frames perdidos: %u (total %llu)\n"
+             "Audio vaciado: %u (total %llu)",
+             r->fps, r->ips, r->frame_p50, r->frame_p99, r->frame_max,
+             r->section_ms[PERF_CPU], r->section_ms[PERF_DRAW], r->section_ms[PERF_AUDIO],
+             r->dropped, (unsigned long long)r->total_dropped,
+             r->underruns, (unsigned long long)r->total_underruns);
+}
+
+void perf_close(perf_t *perf) {
+    if (perf->csv) {
+        fclose(perf->csv);
+        perf->csv = NULL;
+    }
+}
@@ -0,0 +1,206 @@
+#define _POSIX_C_SOURCE 200809L     // Para sysconf
+
+#include "tiles.h"
+#include <stdio.h>
+#include <unistd.h>     // Para sysconf (número de núcleos)
+
+// Un frame completo de una sesión: CPU, timers y escalado a su región del atlas.
+// Devuelve true si la región cambió.
+static bool tile_run_frame(tiles_t *t, tile_t *tile, upscaler_t *up) {
+    for (int i = 0; i < t->cycles_per_frame; i++) {
+        chip8_cycle(&tile->chip8);
+    }
+    chip8_update_timers(&tile->chip8);
+
+    // Misma pantalla que la ya escalada: no hay nada que hacer
+    // (salvo en modo CRT, donde el fósforo sigue apagándose)
+    uint64_t hash = chip8_display_hash(&tile->chip8);
+    if (tile->drawn && hash == tile->drawn_hash && t->filter != UPSCALE_CRT) {
+        return false;
+    }
+    tile->drawn_hash = hash;
+    tile->drawn = true;
+
+    uint32_t *region = t->atlas + tile->x + tile->y * t->atlas_width;
+    up->filter = t->filter;
+    upscale_frame(up, tile->phosphor, tile->chip8.display, SCREEN_WIDTH, SCREEN_HEIGHT,
+                  region, tile->width, tile->height, t->atlas_width);
+    return true;
+}
+
+// Bucle de cada hilo: espera a un frame nuevo y procesa sesiones hasta que no queden
+static void *tiles_worker(void *arg) {
+    tiles_t *t = arg;
+    unsigned seen_frame = 0;
+    upscaler_t *up = &t->upscalers[__sync_fetch_and_add(&t->started, 1)];
+
+    pthread_mutex_lock(&t->lock);
+    for (;;) {
+        while (t->frame == seen_frame && !t->quit) {
+            pthread_cond_wait(&t->start, &t->lock);
+        }
+        if (t->quit) {
+            break;
+        }
+        seen_frame = t->frame;
+        pthread_mutex_unlock(&t->lock);
+
+        int done = 0;
+        int redrawn = 0;
+        for (;;) {
+            int index = __sync_fetch_and_add(&t->next_tile, 1);
+            if (index >= t->count) {
+                break;
+            }
+            if (tile_run_frame(t, &t->tiles[index], up)) {
+                redrawn++;
+            }
+            done++;
+        }
+
+        pthread_mutex_lock(&t->lock);
+        t->finished += done;
+        t->redrawn += redrawn;
+        if (t->finished == t->count) {
+            pthread_cond_signal(&t->done);
+        }
+    }
+    pthread_mutex_unlock(&t->lock);
+    return NULL;
+}
+
+bool tiles_init(tiles_t *t, const char **roms, int count, uint32_t *atlas,
+                int atlas_width, int atlas_height, int cycles_per_frame, int threads) {
+    // Lo primero, para que cualquier error pueda salir con tiles_shutdown()
+    memset(t, 0, sizeof(*t));
+    pthread_mutex_init(&t->lock, NULL);
+    pthread_cond_init(&t->start, NULL);
+    pthread_cond_init(&t->done, NULL);
+
+    t->tiles = calloc(count, sizeof(tile_t));
+    if (!t->tiles) {
+        fprintf(stderr, "Error: No hay memoria para %d sesiones\n", count);
+        tiles_shutdown(t);
+        return false;
+    }
+    t->count = count;
+    t->atlas = atlas;
+    t->atlas_width = atlas_width;
+    t->atlas_height = atlas_height;
+    t->cycles_per_frame = cycles_per_frame;
+
+    // Rejilla casi cuadrada: columnas = techo(raíz(N))
+    t->columns = 1;
+    while (t->columns * t->columns < count) {
+        t->columns++;
+    }
+    t->rows = (count + t->columns - 1) / t->columns;
+
+    for (int i = 0; i < count; i++) {
+        tile_t *tile = &t->tiles[i];
+        chip8_init(&tile->chip8);
+        if (!chip8_load_rom(&tile->chip8, roms[i])) {
+            tiles_shutdown(t);
+            return false;
+        }
+        tile->rom = roms[i];
+
+        // Región del atlas (los bordes se reparten para cubrirlo entero)
+        int column = i % t->columns;
+        int row = i / t->columns;
+        tile->x = column * atlas_width / t->columns;
+        tile->y = row * atlas_height / t->rows;
+        tile->width = (column + 1) * atlas_width / t->columns - tile->x;
+        tile->height = (row + 1) * atlas_height / t->rows - tile->y;
+    }
+
+    // Un hilo por núcleo, pero nunca más hilos que sesiones
+    if (threads <= 0) {
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (threads > count) {
+        threads = count;
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    t->threads = malloc(sizeof(pthread_t) * threads);
+    t->upscalers = malloc(sizeof(upscaler_t) * threads);
+    if (!t->threads || !t->upscalers) {
+        tiles_shutdown(t);
+        return false;
+    }
+    for (int i = 0; i < threads; i++) {
+        upscale_init(&t->upscalers[i], UPSCALE_RGBA(255, 255, 255, 255), UPSCALE_RGBA(0, 0, 0, 255));
+    }
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&t->threads[i], NULL, tiles_worker, t) != 0) {
+            break;
+        }
+        t->thread_count++;
+    }
+    if (t->thread_count == 0) {
+        fprintf(stderr, "Error: No se pudo crear ningún hilo para el modo mosaico\n");
+        tiles_shutdown(t);
+        return false;
+    }
+    return true;
+}
+
+// Ejecuta un frame en todas las sesiones y espera a que terminen
+int tiles_step(tiles_t *t) {
+    pthread_mutex_lock(&t->lock);
+    t->next_tile = 0;
+    t->finished = 0;
+    t->redrawn = 0;
+    t->frame++;
+    pthread_cond_broadcast(&t->start);
+    while (t->finished < t->count) {
+        pthread_cond_wait(&t->done, &t->lock);
+    }
+    int redrawn = t->redrawn;
+    pthread_mutex_unlock(&t->lock);
+    return redrawn;
+}
+
+void tiles_set_filter(tiles_t *t, upscale_filter_t filter) {
+    t->filter = filter;
+    for (int i = 0; i < t->count; i++) {
+        t->tiles[i].drawn = false;      // Hay que volver a escalar con el filtro nuevo
+    }
+}
+
+// Sesión que ocupa el píxel (x, y) del atlas, o -1
+int tiles_hit(const tiles_t *t, int x, int y) {
+    for (int i = 0; i < t->count; i++) {
+        const tile_t *tile = &t->tiles[i];
+        if (x >= tile->x && x < tile->x + tile->width &&
+            y >= tile->y && y < tile->y + tile->height) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Detiene los hilos y libera la memoria. También deshace un tiles_init() a medias.
+void tiles_shutdown(tiles_t *t) {
+    pthread_mutex_lock(&t->lock);
+    t->quit = true;
+    pthread_cond_broadcast(&t->start);
+    pthread_mutex_unlock(&t->lock);
+
+    for (int i = 0; i < t->thread_count; i++) {
+        pthread_join(t->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&t->done);
+    pthread_cond_destroy(&t->start);
+    pthread_mutex_destroy(&t->lock);
+    free(t->threads);
+    free(t->upscalers);
+    free(t->tiles);
+    t->threads = NULL;
+    t->upscalers = NULL;
+    t->tiles = NULL;
+}
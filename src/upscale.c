@@ -0,0 +1,261 @@
+#include "upscale.h"
+#include <string.h>     // Para memcpy
+
+#if defined(__SSE2__)
+#include <emmintrin.h>  // Intrínsecos SSE2 (x86-64 siempre los tiene)
+#endif
+
+// Nombres de los filtros, en el mismo orden que upscale_filter_t
+static const char *filter_names[UPSCALE_FILTER_COUNT] = {
+    "NEAREST",
+    "SCALE2X",
+    "SCALE3X",
+    "CRT"
+};
+
+// Inicializa el escalador con los colores de píxel encendido y apagado
+void upscale_init(upscaler_t *up, uint32_t on_color, uint32_t off_color) {
+    up->filter = UPSCALE_NEAREST;
+
+    // Interpolamos cada canal (R, G, B, A) entre off y on para los 256 niveles.
+    for (int level = 0; level < 256; level++) {
+        uint32_t color = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            int off = (off_color >> shift) & 0xFF;
+            int on = (on_color >> shift) & 0xFF;
+            int channel = off + ((on - off) * level) / 255;
+            color |= (uint32_t)channel << shift;
+        }
+        up->palette[level] = color;
+    }
+
+    memset(up->grid, 0, sizeof(up->grid));
+}
+
+const char *upscale_filter_name(upscale_filter_t filter) {
+    if ((int)filter < 0 || (int)filter >= UPSCALE_FILTER_COUNT) {
+        return "?";
+    }
+    return filter_names[filter];
+}
+
+// --- KERNELS SIMD ---
+
+// Rellena n píxeles consecutivos con el mismo color.
+// Es el bucle más caliente: cada píxel del CHIP-8 ocupa un tramo de SCALE_FACTOR píxeles.
+static void fill_span(uint32_t *dst, int n, uint32_t color) {
+    int i = 0;
+#if defined(__SSE2__)
+    __m128i v = _mm_set1_epi32((int)color);
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_si128((__m128i *)(dst + i), v);
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = color;
+    }
+}
+
+// Oscurece una fila al 50% (línea de barrido del CRT) conservando el canal alfa.
+static void darken_row(uint32_t *row, int n) {
+    const uint32_t rgb_mask = UPSCALE_RGBA(0x7F, 0x7F, 0x7F, 0);
+    const uint32_t alpha_mask = UPSCALE_RGBA(0, 0, 0, 0xFF);
+    int i = 0;
+#if defined(__SSE2__)
+    __m128i rgb = _mm_set1_epi32((int)rgb_mask);
+    __m128i alpha = _mm_set1_epi32((int)alpha_mask);
+    for (; i + 4 <= n; i += 4) {
+        __m128i px = _mm_loadu_si128((const __m128i *)(row + i));
+        __m128i half = _mm_and_si128(_mm_srli_epi32(px, 1), rgb);
+        _mm_storeu_si128((__m128i *)(row + i), _mm_or_si128(half, _mm_and_si128(px, alpha)));
+    }
+#endif
+    for (; i < n; i++) {
+        row[i] = ((row[i] >> 1) & rgb_mask) | (row[i] & alpha_mask);
+    }
+}
+
+// Convierte el buffer 0/1 del CHIP-8 en intensidades 0/255.
+static void binary_to_levels(uint8_t *dst, const uint8_t *src, int n) {
+    int i = 0;
+#if defined(__SSE2__)
+    __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        // 0xFF donde el píxel es distinto de 0
+        __m128i on = _mm_andnot_si128(_mm_cmpeq_epi8(s, zero), _mm_set1_epi8(-1));
+        _mm_storeu_si128((__m128i *)(dst + i), on);
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = src[i] ? 0xFF : 0x00;
+    }
+}
+
+// Persistencia del fósforo: cada frame la intensidad cae un 25%,
+// y los píxeles encendidos vuelven a brillar al máximo.
+static void phosphor_update(uint8_t *phosphor, const uint8_t *src, int n) {
+    int i = 0;
+#if defined(__SSE2__)
+    __m128i zero = _mm_setzero_si128();
+    __m128i low6 = _mm_set1_epi8(0x3F);
+    for (; i + 16 <= n; i += 16) {
+        __m128i p = _mm_loadu_si128((const __m128i *)(phosphor + i));
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i on = _mm_andnot_si128(_mm_cmpeq_epi8(s, zero), _mm_set1_epi8(-1));
+        // p >> 2 por byte (SSE2 no tiene desplazamiento de 8 bits: desplazamos 16 y enmascaramos)
+        __m128i quarter = _mm_and_si128(_mm_srli_epi16(p, 2), low6);
+        p = _mm_max_epu8(_mm_subs_epu8(p, quarter), on);
+        _mm_storeu_si128((__m128i *)(phosphor + i), p);
+    }
+#endif
+    for (; i < n; i++) {
+        uint8_t decayed = phosphor[i] - (phosphor[i] >> 2);
+        phosphor[i] = src[i] ? 0xFF : decayed;
+    }
+}
+
+// --- FILTROS DE SUAVIZADO ---
+// Trabajan sobre la rejilla de intensidades, que es muy pequeña (64x32),
+// así que no merece la pena vectorizarlos.
+
+// Lee un píxel de origen con las coordenadas limitadas al borde
+static uint8_t pixel_at(const uint8_t *src, int sw, int sh, int x, int y) {
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x >= sw) x = sw - 1;
+    if (y >= sh) y = sh - 1;
+    return src[x + y * sw] ? 0xFF : 0x00;
+}
+
+// Scale2x (EPX): cada píxel se convierte en un bloque 2x2 que redondea las esquinas.
+static void scale2x(uint8_t *grid, const uint8_t *src, int sw, int sh) {
+    int gw = sw * 2;
+    for (int y = 0; y < sh; y++) {
+        for (int x = 0; x < sw; x++) {
+            uint8_t a = pixel_at(src, sw, sh, x, y - 1);   // Arriba
+            uint8_t b = pixel_at(src, sw, sh, x + 1, y);   // Derecha
+            uint8_t c = pixel_at(src, sw, sh, x - 1, y);   // Izquierda
+            uint8_t d = pixel_at(src, sw, sh, x, y + 1);   // Abajo
+            uint8_t p = pixel_at(src, sw, sh, x, y);
+
+            uint8_t *out = &grid[(x * 2) + (y * 2) * gw];
+            out[0]      = (c == a && c != d && a != b) ? a : p;
+            out[1]      = (a == b && a != c && b != d) ? b : p;
+            out[gw]     = (d == c && d != b && c != a) ? c : p;
+            out[gw + 1] = (b == d && b != a && d != c) ? d : p;
+        }
+    }
+}
+
+// Scale3x (AdvMAME3x): igual que Scale2x pero con bloques 3x3.
+static void scale3x(uint8_t *grid, const uint8_t *src, int sw, int sh) {
+    int gw = sw * 3;
+    for (int y = 0; y < sh; y++) {
+        for (int x = 0; x < sw; x++) {
+            // Vecindario 3x3:  A B C / D E F / G H I
+            uint8_t a = pixel_at(src, sw, sh, x - 1, y - 1);
+            uint8_t b = pixel_at(src, sw, sh, x,     y - 1);
+            uint8_t c = pixel_at(src, sw, sh, x + 1, y - 1);
+            uint8_t d = pixel_at(src, sw, sh, x - 1, y);
+            uint8_t e = pixel_at(src, sw, sh, x,     y);
+            uint8_t f = pixel_at(src, sw, sh, x + 1, y);
+            uint8_t g = pixel_at(src, sw, sh, x - 1, y + 1);
+            uint8_t h = pixel_at(src, sw, sh, x,     y + 1);
+            uint8_t i = pixel_at(src, sw, sh, x + 1, y + 1);
+
+            uint8_t *out = &grid[(x * 3) + (y * 3) * gw];
+
+            if (b != h && d != f) {
+                out[0]          = (d == b) ? d : e;
+                out[1]          = ((d == b && e != c) || (b == f && e != a)) ? b : e;
+                out[2]          = (b == f) ? f : e;
+                out[gw]         = ((d == b && e != g) || (d == h && e != a)) ? d : e;
+                out[gw + 1]     = e;
+                out[gw + 2]     = ((b == f && e != i) || (h == f && e != c)) ? f : e;
+                out[gw * 2]     = (d == h) ? d : e;
+                out[gw * 2 + 1] = ((d == h && e != i) || (h == f && e != g)) ? h : e;
+                out[gw * 2 + 2] = (h == f) ? f : e;
+            } else {
+                for (int row = 0; row < 3; row++) {
+                    out[row * gw] = out[row * gw + 1] = out[row * gw + 2] = e;
+                }
+            }
+        }
+    }
+}
+
+// --- EXPANSIÓN FINAL ---
+
+// Expande la rejilla de intensidades (gw x gh) hasta dst (dw x dh).
+// Cada celda ocupa un tramo de columnas y filas; construimos la primera fila
+// de cada tramo con fill_span y copiamos el resto con memcpy.
+static void expand_grid(const upscaler_t *up, const uint8_t *grid, int gw, int gh,
+                        uint32_t *dst, int dw, int dh, int pitch, int scanlines) {
+    for (int gy = 0; gy < gh; gy++) {
+        int y0 = (gy * dh) / gh;
+        int y1 = ((gy + 1) * dh) / gh;
+        if (y1 <= y0) {
+            continue;
+        }
+
+        uint32_t *first = dst + y0 * pitch;
+        const uint8_t *levels = grid + gy * gw;
+        for (int gx = 0; gx < gw; gx++) {
+            int x0 = (gx * dw) / gw;
+            int x1 = ((gx + 1) * dw) / gw;
+            fill_span(first + x0, x1 - x0, up->palette[levels[gx]]);
+        }
+
+        // En modo CRT, el último tercio de cada celda es una línea de barrido oscura.
+        int height = y1 - y0;
+        int dark_from = height;
+        if (scanlines && height >= 2) {
+            int dark = height / 3;
+            dark_from = height - (dark > 0 ? dark : 1);
+        }
+
+        for (int row = 1; row < height; row++) {
+            uint32_t *line = first + row * pitch;
+            if (row == dark_from) {
+                memcpy(line, first, sizeof(uint32_t) * dw);
+                darken_row(line, dw);
+            } else if (row > dark_from) {
+                memcpy(line, first + dark_from * pitch, sizeof(uint32_t) * dw);
+            } else {
+                memcpy(line, first, sizeof(uint32_t) * dw);
+            }
+        }
+    }
+}
+
+// Escala el buffer src (sw x sh) hacia dst (dw x dh) con el filtro activo
+void upscale_frame(upscaler_t *up, uint8_t *phosphor, const uint8_t *src, int sw, int sh,
+                   uint32_t *dst, int dw, int dh, int pitch) {
+    if (sw > UPSCALE_MAX_SRC_WIDTH || sh > UPSCALE_MAX_SRC_HEIGHT) {
+        return;
+    }
+
+    switch (up->filter) {
+        case UPSCALE_SCALE2X:
+            scale2x(up->grid, src, sw, sh);
+            expand_grid(up, up->grid, sw * 2, sh * 2, dst, dw, dh, pitch, 0);
+            break;
+
+        case UPSCALE_SCALE3X:
+            scale3x(up->grid, src, sw, sh);
+            expand_grid(up, up->grid, sw * 3, sh * 3, dst, dw, dh, pitch, 0);
+            break;
+
+        case UPSCALE_CRT:
+            phosphor_update(phosphor, src, sw * sh);
+            expand_grid(up, phosphor, sw, sh, dst, dw, dh, pitch, 1);
+            break;
+
+        case UPSCALE_NEAREST:
+        default:
+            binary_to_levels(up->grid, src, sw * sh);
+            expand_grid(up, up->grid, sw, sh, dst, dw, dh, pitch, 0);
+            break;
+    }
+}
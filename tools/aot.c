@@ -0,0 +1,483 @@
+// Traductor anticipado (AOT) de ROMs CHIP-8 a C.
+//
+// Recorre el código de la ROM desde START_ADDRESS siguiendo saltos, llamadas
+// y skips, lo divide en bloques básicos y escribe un archivo C con una función
+// por bloque que opera directamente sobre chip8_t. Si se indica un .so, lo
+// compila con el compilador del sistema para cargarlo con "chip8 -a".
+//
+// Las instrucciones sencillas (cargas, ALU, saltos, CALL/RET, espera de tecla,
+// FX65) se generan en línea; el resto (DXYN, CXNN, EX9E/EXA1, FX33/FX55) se
+// delega en chip8_execute(), así que los fallos, watchpoints y el hash de
+// pantalla se comportan igual que en el intérprete.
+//
+// Uso: aot [-I dir_include] rom.ch8 salida.c [salida.so]
+//
+// El compilador es $CC (o cc) y se ejecuta sin shell, así que $CC tiene que
+// ser el nombre o la ruta de un programa, sin argumentos.
+
+#define _POSIX_C_SOURCE 199309L     // Para fork y waitpid
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>     // Para fork y execvp
+#include <sys/wait.h>   // Para waitpid
+#include "chip8.h"
+#include "aot.h"
+
+// Instrucciones máximas por bloque. Un tramo más largo se corta y la
+// instrucción siguiente pasa a empezar otro bloque (ver emit_block).
+#define MAX_BLOCK_INSTRUCTIONS 64
+
+// Una instrucción continúa como mucho en dos sitios (skips y CALL)
+#define MAX_SUCCESSORS 2
+
+// Imagen de memoria con la ROM cargada y qué direcciones son código
+static uint8_t memory[RAM_SIZE];
+static bool visited[RAM_SIZE];      // Se alcanza una instrucción en esta dirección
+static bool leader[RAM_SIZE];       // Aquí empieza un bloque básico
+static int rom_end;                 // Primera dirección después de la ROM
+
+// Cómo se traduce cada instrucción
+typedef enum {
+    OP_UNKNOWN,     // No implementada: se deja al intérprete (que registra el fallo)
+    OP_INLINE,      // Se genera en C directamente
+    OP_EXEC         // Se delega en chip8_execute()
+} op_kind_t;
+
+// Información de flujo de una instrucción
+typedef struct {
+    op_kind_t kind;
+    bool ends_block;    // Cambia el PC
+    int successors[MAX_SUCCESSORS];  // Direcciones a las que puede continuar (conocidas)
+    int successor_count;
+} op_info_t;
+
+static uint16_t fetch(int addr) {
+    return (memory[addr] << 8) | memory[addr + 1];
+}
+
+static op_info_t decode(int addr, uint16_t op) {
+    op_info_t info;
+    info.kind = OP_INLINE;
+    info.ends_block = false;
+    info.successors[0] = addr + 2;      // Por defecto, la instrucción siguiente
+    info.successors[1] = 0;
+    info.successor_count = 1;
+    uint8_t nn = op & 0xFF;
+
+    switch (op & 0xF000) {
+        case 0x0000:
+            if (op == 0x00E0) {
+                info.kind = OP_EXEC;
+            } else if (op == 0x00EE) {
+                info.ends_block = true;         // Destino desconocido (pila)
+                info.successor_count = 0;
+            }
+            break;                              // 0NNN: se ignora, como en el intérprete
+
+        case 0x1000:
+            info.ends_block = true;
+            info.successors[0] = op & 0x0FFF;
+            break;
+
+        case 0x2000:
+            info.ends_block = true;
+            info.successors[0] = op & 0x0FFF;
+            info.successors[1] = addr + 2;      // Vuelta del RET
+            info.successor_count = 2;
+            break;
+
+        case 0x3000: case 0x4000: case 0x5000: case 0x9000:
+            info.ends_block = true;
+            info.successors[1] = addr + 4;
+            info.successor_count = 2;
+            break;
+
+        case 0x6000: case 0x7000: case 0xA000:
+            break;
+
+        case 0x8000:
+            switch (op & 0xF) {
+                case 0x0: case 0x1: case 0x2: case 0x3: case 0x4:
+                case 0x5: case 0x6: case 0x7: case 0xE:
+                    break;
+                default:
+                    info.kind = OP_UNKNOWN;
+                    break;
+            }
+            break;
+
+        case 0xC000: case 0xD000:
+            info.kind = OP_EXEC;
+            break;
+
+        case 0xE000:
+            if (nn == 0x9E || nn == 0xA1) {
+                info.kind = OP_EXEC;
+                info.ends_block = true;
+                info.successors[1] = addr + 4;
+                info.successor_count = 2;
+            } else {
+                info.kind = OP_UNKNOWN;
+            }
+            break;
+
+        case 0xF000:
+            switch (nn) {
+                case 0x07: case 0x15: case 0x18: case 0x1E: case 0x29: case 0x65:
+                    break;
+                case 0x0A:                      // Espera de tecla: se repite a sí misma
+                    info.ends_block = true;
+                    break;
+                case 0x33: case 0x55:           // Escriben memoria (ver emit_block)
+                    info.kind = OP_EXEC;
+                    break;
+                default:
+                    info.kind = OP_UNKNOWN;
+                    break;
+            }
+            break;
+
+        default:                                // BNNN no está implementada
+            info.kind = OP_UNKNOWN;
+            break;
+    }
+
+    if (info.kind == OP_UNKNOWN) {
+        info.ends_block = true;
+        info.successor_count = 0;
+    }
+    return info;
+}
+
+static bool is_code_address(int addr) {
+    return addr >= START_ADDRESS && addr + 1 < rom_end;
+}
+
+// Recorre todo el código alcanzable y marca los inicios de bloque
+static void discover(void) {
+    static int worklist[RAM_SIZE * 2];
+    int pending = 0;
+
+    worklist[pending++] = START_ADDRESS;
+    leader[START_ADDRESS] = true;
+
+    while (pending > 0) {
+        int addr = worklist[--pending];
+        if (!is_code_address(addr) || visited[addr]) {
+            continue;
+        }
+        visited[addr] = true;
+
+        op_info_t info = decode(addr, fetch(addr));
+        for (int i = 0; i < info.successor_count && i < MAX_SUCCESSORS; i++) {
+            int next = info.successors[i];
+            if (info.ends_block) {
+                leader[next & (RAM_SIZE - 1)] = true;
+            }
+            if (pending < RAM_SIZE * 2) {
+                worklist[pending++] = next;
+            }
+        }
+    }
+}
+
+// --- GENERACIÓN DE CÓDIGO ---
+
+// Instrucción que se genera en línea
+static void emit_inline(FILE *out, int addr, uint16_t op) {
+    int x = (op >> 8) & 0xF;
+    int y = (op >> 4) & 0xF;
+    int nn = op & 0xFF;
+    int nnn = op & 0xFFF;
+
+    switch (op & 0xF000) {
+        case 0x6000: fprintf(out, "    c->V[0x%X] = 0x%02X;\n", x, nn); break;
+        case 0x7000: fprintf(out, "    c->V[0x%X] += 0x%02X;\n", x, nn); break;
+        case 0xA000: fprintf(out, "    c->I = 0x%03X;\n", nnn); break;
+
+        case 0x8000:
+            // Mismo orden de operaciones que chip8.c (importa cuando X o Y es F)
+            switch (op & 0xF) {
+                case 0x0: fprintf(out, "    c->V[0x%X] = c->V[0x%X];\n", x, y); break;
+                case 0x1: fprintf(out, "    c->V[0x%X] |= c->V[0x%X];\n", x, y); break;
+                case 0x2: fprintf(out, "    c->V[0x%X] &= c->V[0x%X];\n", x, y); break;
+                case 0x3: fprintf(out, "    c->V[0x%X] ^= c->V[0x%X];\n", x, y); break;
+                case 0x4:
+                    fprintf(out, "    { uint16_t sum = c->V[0x%X] + c->V[0x%X]; "
+                                 "c->V[0xF] = (sum > 255); c->V[0x%X] = sum & 0xFF; }\n", x, y, x);
+                    break;
+                case 0x5:
+                    fprintf(out, "    c->V[0xF] = (c->V[0x%X] >= c->V[0x%X]); c->V[0x%X] -= c->V[0x%X];\n",
+                            x, y, x, y);
+                    break;
+                case 0x7:
+                    fprintf(out, "    c->V[0xF] = (c->V[0x%X] >= c->V[0x%X]); c->V[0x%X] = c->V[0x%X] - c->V[0x%X];\n",
+                            y, x, x, y, x);
+                    break;
+                case 0x6:
+                    fprintf(out, "    c->V[0xF] = (c->V[0x%X] & 0x1); c->V[0x%X] >>= 1;\n", x, x);
+                    break;
+                case 0xE:
+                    fprintf(out, "    c->V[0xF] = (c->V[0x%X] & 0x80) >> 7; c->V[0x%X] <<= 1;\n", x, x);
+                    break;
+            }
+            break;
+
+        case 0xF000:
+            switch (nn) {
+                case 0x07: fprintf(out, "    c->V[0x%X] = c->delay_timer;\n", x); break;
+                case 0x15: fprintf(out, "    c->delay_timer = c->V[0x%X];\n", x); break;
+                case 0x18: fprintf(out, "    c->sound_timer = c->V[0x%X];\n", x); break;
+                case 0x1E: fprintf(out, "    c->I += c->V[0x%X];\n", x); break;
+                case 0x29: fprintf(out, "    c->I = 0x%02X + (c->V[0x%X] * 5);\n", FONTSET_START_ADDRESS, x); break;
+                case 0x65:
+                    // Con watchpoints o I fuera de rango, el intérprete avisa o registra el fallo
+                    fprintf(out, "    if (!c->watch && c->I + 0x%X < RAM_SIZE) {\n"
+                                 "        for (int i = 0; i <= 0x%X; i++) c->V[i] = c->memory[c->I + i];\n"
+                                 "    } else { c->pc = 0x%03X; exec(c, 0x%04X); }\n", x, x, addr + 2, op);
+                    break;
+            }
+            break;
+
+        default:
+            break;      // 0NNN: se ignora
+    }
+}
+
+// Último paso de una instrucción de salto/skip/espera de tecla generada en línea
+static void emit_inline_branch(FILE *out, int addr, uint16_t op) {
+    int x = (op >> 8) & 0xF;
+    int y = (op >> 4) & 0xF;
+    int nn = op & 0xFF;
+    const char *fmt = "    c->pc = (%s) ? 0x%03X : 0x%03X;\n";
+    char cond[64];
+
+    switch (op & 0xF000) {
+        case 0x1000:
+            fprintf(out, "    c->pc = 0x%03X;\n", op & 0xFFF);
+            return;
+        case 0x0000:
+            // 00EE (RET). Con la pila vacía, el intérprete registra el fallo.
+            fprintf(out, "    if (c->sp > 0) { c->sp--; c->pc = c->stack[c->sp]; }\n"
+                         "    else { c->pc = 0x%03X; exec(c, 0x%04X); }\n", addr + 2, op);
+            return;
+        case 0x2000:
+            // CALL. Con la pila llena, el intérprete registra el fallo.
+            fprintf(out, "    if (c->sp < STACK_SIZE) { c->stack[c->sp] = 0x%03X; c->sp++; c->pc = 0x%03X; }\n"
+                         "    else { c->pc = 0x%03X; exec(c, 0x%04X); }\n",
+                    addr + 2, op & 0xFFF, addr + 2, op);
+            return;
+        case 0xF000:
+            // FX0A: sin tecla, el intérprete repite la instrucción sin cambiar nada
+            // más. El teclado no cambia durante una llamada, así que la espera se
+            // come de golpe todo el presupuesto que queda.
+            fprintf(out, "    { int key = 0; while (key < NUM_KEYS && !c->keypad[key]) key++;\n"
+                         "      if (key == NUM_KEYS) { c->pc = 0x%03X; return budget; }\n"
+                         "      c->V[0x%X] = key; c->pc = 0x%03X; }\n", addr, x, addr + 2);
+            return;
+        case 0x3000: snprintf(cond, sizeof(cond), "c->V[0x%X] == 0x%02X", x, nn); break;
+        case 0x4000: snprintf(cond, sizeof(cond), "c->V[0x%X] != 0x%02X", x, nn); break;
+        case 0x5000: snprintf(cond, sizeof(cond), "c->V[0x%X] == c->V[0x%X]", x, y); break;
+        case 0x9000: snprintf(cond, sizeof(cond), "c->V[0x%X] != c->V[0x%X]", x, y); break;
+        default: return;
+    }
+    fprintf(out, fmt, cond, addr + 4, addr + 2);
+}
+
+// Genera la función de un bloque. Devuelve su tamaño en bytes (0 si está vacío).
+static int emit_block(FILE *out, int start) {
+    // Primero medimos el bloque
+    int addr = start;
+    int count = 0;
+    bool split = false;
+    while (is_code_address(addr) && visited[addr]) {
+        if (count == MAX_BLOCK_INSTRUCTIONS) {
+            split = true;
+            break;
+        }
+        if (count > 0 && leader[addr]) {
+            break;
+        }
+        op_info_t info = decode(addr, fetch(addr));
+        if (info.kind == OP_UNKNOWN) {
+            break;
+        }
+        addr += 2;
+        count++;
+        if (info.ends_block) {
+            break;
+        }
+    }
+    if (count == 0) {
+        return 0;
+    }
+    int end = addr;
+
+    // Bloque cortado por tamaño: el resto del tramo será el siguiente bloque
+    // (generate() recorre las direcciones en orden, así que aún no ha llegado aquí)
+    if (split) {
+        leader[end] = true;
+    }
+
+    fprintf(out, "static int block_%03X(chip8_t *c, int budget) {\n", start);
+    fprintf(out, "    (void)budget;\n");
+
+    bool closed = false;
+    for (int k = 0, a = start; a < end; k++, a += 2) {
+        uint16_t op = fetch(a);
+        op_info_t info = decode(a, op);
+
+        // Si el presupuesto de ciclos se acaba a mitad de bloque, paramos aquí
+        if (k > 0) {
+            fprintf(out, "    if (budget == %d) { c->pc = 0x%03X; return %d; }\n", k, a, k);
+        }
+        fprintf(out, "    /* 0x%03X: %04X */\n", a, op);
+
+        if (info.kind == OP_EXEC) {
+            fprintf(out, "    c->pc = 0x%03X; exec(c, 0x%04X);\n", a + 2, op);
+            closed = info.ends_block;
+
+            // FX33/FX55: si lo escrito pisa el resto de este bloque, salimos y el
+            // despachador lo vuelve a comparar con sus bytes originales
+            bool writes = (op & 0xF0FF) == 0xF033 || (op & 0xF0FF) == 0xF055;
+            if (writes && a + 2 < end) {
+                fprintf(out, "    if (c->written_start < 0x%03X && c->written_end > 0x%03X) "
+                             "{ c->pc = 0x%03X; return %d; }\n", end, a + 2, a + 2, k + 1);
+            }
+        } else if (info.ends_block) {
+            emit_inline_branch(out, a, op);
+            closed = true;
+        } else {
+            emit_inline(out, a, op);
+        }
+    }
+
+    // Bloque que termina sin salto: continúa en la instrucción siguiente
+    if (!closed) {
+        fprintf(out, "    c->pc = 0x%03X;\n", end);
+    }
+    fprintf(out, "    return %d;\n}\n\n", count);
+
+    // Bytes originales para detectar código automodificado
+    fprintf(out, "static const uint8_t code_%03X[] = {", start);
+    for (int a = start; a < end; a++) {
+        fprintf(out, "%s0x%02X", (a == start) ? " " : ", ", memory[a]);
+    }
+    fprintf(out, " };\n\n");
+
+    return end - start;
+}
+
+static bool generate(const char *rom_path, const char *c_path) {
+    FILE *out = fopen(c_path, "w");
+    if (!out) {
+        fprintf(stderr, "Error: No se pudo escribir %s\n", c_path);
+        return false;
+    }
+
+    fprintf(out, "// Generado por tools/aot a partir de %s. No editar.\n", rom_path);
+    fprintf(out, "#include \"chip8.h\"\n#include \"aot.h\"\n\n");
+    fprintf(out, "static chip8_aot_exec_fn exec;\n\n");
+    fprintf(out, "static void bind(chip8_aot_exec_fn fn) {\n    exec = fn;\n}\n\n");
+
+    static int starts[RAM_SIZE];
+    static int lengths[RAM_SIZE];
+    int blocks = 0;
+    for (int addr = START_ADDRESS; addr < rom_end; addr++) {
+        if (leader[addr] && visited[addr]) {
+            int length = emit_block(out, addr);
+            if (length > 0) {
+                starts[blocks] = addr;
+                lengths[blocks] = length;
+                blocks++;
+            }
+        }
+    }
+
+    fprintf(out, "static const chip8_aot_block_t blocks[] = {\n");
+    for (int i = 0; i < blocks; i++) {
+        fprintf(out, "    { 0x%03X, %d, code_%03X, block_%03X },\n",
+                starts[i], lengths[i], starts[i], starts[i]);
+    }
+    if (blocks == 0) {
+        fprintf(out, "    { 0, 0, NULL, NULL }\n");
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "const chip8_aot_module_t %s = {\n", CHIP8_AOT_SYMBOL);
+    fprintf(out, "    CHIP8_AOT_ABI, sizeof(chip8_t), CHIP8_AOT_OFFSETS, %d, blocks, bind\n};\n", blocks);
+
+    fclose(out);
+    printf("%s: %d bloques traducidos\n", c_path, blocks);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    const char *include_dir = "include";
+    int arg = 1;
+    if (arg + 1 < argc && strcmp(argv[arg], "-I") == 0) {
+        include_dir = argv[arg + 1];
+        arg += 2;
+    }
+    if (argc - arg < 2 || argc - arg > 3) {
+        fprintf(stderr, "Uso: %s [-I dir_include] rom.ch8 salida.c [salida.so]\n", argv[0]);
+        return 2;
+    }
+    const char *rom_path = argv[arg];
+    const char *c_path = argv[arg + 1];
+    const char *so_path = (argc - arg == 3) ? argv[arg + 2] : NULL;
+
+    // Cargamos la ROM igual que el emulador
+    static chip8_t chip8;
+    chip8_init(&chip8);
+    if (!chip8_load_rom(&chip8, rom_path)) {
+        return 2;
+    }
+    memcpy(memory, chip8.memory, RAM_SIZE);
+
+    FILE *rom = fopen(rom_path, "rb");
+    if (!rom) {
+        fprintf(stderr, "Error: No se pudo abrir %s\n", rom_path);
+        return 2;
+    }
+    fseek(rom, 0, SEEK_END);
+    rom_end = START_ADDRESS + (int)ftell(rom);
+    fclose(rom);
+
+    discover();
+    if (!generate(rom_path, c_path)) {
+        return 2;
+    }
+
+    // Compilamos con el compilador del sistema ($CC o cc)
+    if (so_path) {
+        const char *cc = getenv("CC");
+        char include_flag[1024];
+        snprintf(include_flag, sizeof(include_flag), "-I%s", include_dir);
+        char *const command[] = {
+            (char *)(cc ? cc : "cc"), "-std=c99", "-O2", "-shared", "-fPIC",
+            include_flag, (char *)c_path, "-o", (char *)so_path, NULL
+        };
+        for (int i = 0; command[i]; i++) {
+            printf("%s%s", (i > 0) ? " " : "", command[i]);
+        }
+        printf("\n");
+        fflush(stdout);     // Que el comando salga antes que los errores del compilador
+
+        // Sin shell: las rutas se pasan tal cual, aunque tengan comillas o espacios
+        pid_t pid = fork();
+        if (pid == 0) {
+            execvp(command[0], command);
+            _exit(127);
+        }
+        int status;
+        if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "Error: falló la compilación de %s\n", c_path);
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,619 @@
+// Microbenchmarks del núcleo CHIP-8.
+//
+// Mide cuánto tarda chip8_cycle() por instrucción en distintas clases de opcodes
+// (ALU, saltos, CALL/RET, DXYN, FX33/FX55/FX65) y en ROMs completas.
+// Escribe los resultados en JSON y, si se le da un baseline, falla cuando
+// el rendimiento cae por debajo del umbral indicado.
+//
+// Las repeticiones se hacen por rondas (una pasada de cada benchmark por
+// ronda) y se compara el mejor tiempo (el mínimo): las interrupciones y los
+// cambios de frecuencia de la CPU solo hacen más lenta una pasada, nunca más
+// rápida, y al intercalar los benchmarks un mal momento de la máquina se
+// reparte entre todos en lugar de estropear todas las pasadas de uno. Además,
+// una caída solo cuenta como regresión si supera el umbral y también
+// REGRESSION_SIGMAS desviaciones típicas del baseline.
+//
+// Con -a <traductor> (build/aot), cada programa y ROM se traduce también a
+// código nativo y se mide con chip8_aot_run() como "aot:<nombre>", así que el
+// baseline vigila igual la velocidad del camino AOT.
+//
+// Uso: bench [-n instrucciones] [-r repeticiones] [-o salida.json]
+//            [-b baseline.json] [-t umbral_%] [-a traductor] [rom.ch8 ...]
+
+#define _POSIX_C_SOURCE 199309L     // Para clock_gettime, fork y waitpid
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <fcntl.h>      // Para open
+#include <unistd.h>     // Para fork, dup2 y execv
+#include <sys/wait.h>   // Para waitpid
+#include "chip8.h"
+#include "aot.h"
+
+// Instrucciones entre actualizaciones de timers en las ROMs completas
+// (igual que CYCLES_PER_FRAME en main.c)
+#define CYCLES_PER_FRAME 10
+
+// Frames que se mantiene pulsada cada tecla en las ROMs completas (ver run_once)
+#define KEY_HOLD_FRAMES 30
+
+#define MAX_BENCHMARKS 64
+
+// Desviaciones típicas del baseline que tiene que superar una caída para
+// contar como regresión (además del umbral en %)
+#define REGRESSION_SIGMAS 3.0
+#define MAX_NAME 128
+
+// Archivos intermedios del modo AOT (ROM sintética, C generado y .so)
+#define AOT_WORK_PREFIX "build/bench_aot"
+
+// Programa sintético: lista de opcodes que se copian a partir de START_ADDRESS.
+// Todos terminan con un salto (1NNN) hacia atrás para repetirse indefinidamente.
+typedef struct {
+    const char *name;
+    const uint16_t *code;
+    int length;
+} synthetic_rom_t;
+
+// Un benchmark preparado: estado inicial, cómo se ejecuta y sus muestras
+typedef struct {
+    char name[MAX_NAME];
+    chip8_t initial;
+    bool with_timers;       // ROM completa: timers a 60Hz simulados
+    chip8_aot_t *aot;       // Módulo nativo, o NULL para el intérprete
+    double *samples;        // ns/instrucción de cada pasada
+} benchmark_t;
+
+// Resultado de un benchmark
+typedef struct {
+    char name[MAX_NAME];
+    double ns_mean;
+    double ns_stddev;
+    double ns_median;
+    double ns_min;      // Mejor pasada: es la que se compara con el baseline
+    double ips;         // Instrucciones por segundo (a partir del mínimo)
+} result_t;
+
+// --- PROGRAMAS SINTÉTICOS ---
+
+// 8XY*: todas las operaciones aritméticas y lógicas entre registros
+static const uint16_t rom_alu[] = {
+    0x6011, 0x6122, 0x7001,
+    0x8010, 0x8011, 0x8012, 0x8013, 0x8014,
+    0x8015, 0x8016, 0x8017, 0x801E,
+    0x8120, 0x8124, 0x8125, 0x8126,
+    0x1200
+};
+
+// 3XNN/4XNN/5XY0/9XY0: saltos condicionales, tomados y no tomados.
+// El último opcode antes del JP nunca es un skip, así el bucle siempre cierra.
+static const uint16_t rom_branch[] = {
+    0x6005, 0x6105,
+    0x3005, 0x6000,     // Tomado
+    0x3006, 0x6005,     // No tomado
+    0x4005, 0x6000,     // No tomado
+    0x4006, 0x6000,     // Tomado
+    0x5010, 0x6000,     // Tomado / no tomado según V0
+    0x9010, 0x6005,
+    0x1200
+};
+
+// 2NNN/00EE: llamada a subrutina y retorno
+static const uint16_t rom_call[] = {
+    0x2206,             // 0x200: CALL 0x206
+    0x2206,             // 0x202: CALL 0x206
+    0x1200,             // 0x204: JP 0x200
+    0x00EE              // 0x206: RET
+};
+
+// DXYN con alturas distintas, usando los sprites de la fuente (I = 0x50)
+static const uint16_t rom_draw_h1[] = {
+    0xA050, 0x6008, 0x6108, 0xD011, 0x1206
+};
+static const uint16_t rom_draw_h8[] = {
+    0xA050, 0x6008, 0x6108, 0xD018, 0x1206
+};
+static const uint16_t rom_draw_h15[] = {
+    0xA050, 0x6008, 0x6108, 0xD01F, 0x1206
+};
+
+// DXYN en la esquina inferior derecha: casi todos los píxeles se recortan
+static const uint16_t rom_draw_clip[] = {
+    0xA050, 0x603C, 0x611C, 0xD01F, 0x1206
+};
+
+// FX33/FX55/FX65: BCD y volcado/carga de registros en memoria
+static const uint16_t rom_mem[] = {
+    0xA300, 0x60FD,
+    0xF033, 0xFF55, 0xFF65,
+    0xF733, 0xF755, 0xF765,
+    0x1202
+};
+
+#define SYNTHETIC(name, code) { name, code, (int)(sizeof(code) / sizeof(code[0])) }
+
+static const synthetic_rom_t synthetic_roms[] = {
+    SYNTHETIC("alu", rom_alu),
+    SYNTHETIC("branch", rom_branch),
+    SYNTHETIC("call_ret", rom_call),
+    SYNTHETIC("draw_h1", rom_draw_h1),
+    SYNTHETIC("draw_h8", rom_draw_h8),
+    SYNTHETIC("draw_h15", rom_draw_h15),
+    SYNTHETIC("draw_clip", rom_draw_clip),
+    SYNTHETIC("mem_bcd_ld", rom_mem),
+};
+
+// --- MEDICIÓN ---
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double da = *(const double *)a;
+    double db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+// Ejecuta exactamente 'instructions' ciclos sobre una copia del estado inicial
+// y devuelve los nanosegundos por instrucción. Con aot != NULL usa el módulo nativo.
+//
+// En las ROMs completas siempre hay una tecla pulsada (una distinta cada
+// KEY_HOLD_FRAMES frames). Sin teclas, FX0A se queda esperando: el intérprete
+// repite la instrucción en cada ciclo y el código nativo se salta de golpe el
+// resto del frame, así que los ciclos no serían instrucciones ejecutadas y los
+// dos caminos no se podrían comparar. Con una tecla pulsada FX0A nunca espera
+// y cada ciclo es una instrucción de verdad en ambos.
+static double run_once(const chip8_t *initial, long instructions, bool with_timers,
+                       chip8_aot_t *aot) {
+    static chip8_t chip8;   // static: chip8_t ocupa más de 6KB
+    chip8 = *initial;
+
+    double start = now_ns();
+    if (with_timers) {
+        long frame = 0;
+        for (long i = 0; i < instructions; i += CYCLES_PER_FRAME, frame++) {
+            memset(chip8.keypad, 0, sizeof(chip8.keypad));
+            chip8.keypad[(frame / KEY_HOLD_FRAMES) % NUM_KEYS] = true;
+
+            // El último frame solo ejecuta lo que falta
+            long left = instructions - i;
+            int cycles = (left < CYCLES_PER_FRAME) ? (int)left : CYCLES_PER_FRAME;
+            if (aot) {
+                chip8_aot_run(aot, &chip8, cycles);
+            } else {
+                for (int c = 0; c < cycles; c++) {
+                    chip8_cycle(&chip8);
+                }
+            }
+            chip8_update_timers(&chip8);
+        }
+    } else if (aot) {
+        // Por tramos para no pasarnos del rango de int
+        for (long i = 0; i < instructions; i += 1 << 20) {
+            long left = instructions - i;
+            chip8_aot_run(aot, &chip8, (int)(left < (1 << 20) ? left : (1 << 20)));
+        }
+    } else {
+        for (long i = 0; i < instructions; i++) {
+            chip8_cycle(&chip8);
+        }
+    }
+    double elapsed = now_ns() - start;
+
+    // Evitamos que el compilador descarte la simulación
+    volatile uint8_t sink = chip8.V[0] ^ chip8.display[0];
+    (void)sink;
+
+    return elapsed / instructions;
+}
+
+// Mide todos los benchmarks por rondas: en cada ronda, una pasada de cada uno
+static void measure_all(benchmark_t *benchmarks, int count, long instructions, int runs) {
+    // Una pasada de calentamiento (cachés, predictor de saltos)
+    for (int b = 0; b < count; b++) {
+        run_once(&benchmarks[b].initial, instructions / 10 + 1,
+                 benchmarks[b].with_timers, benchmarks[b].aot);
+    }
+
+    for (int r = 0; r < runs; r++) {
+        for (int b = 0; b < count; b++) {
+            benchmarks[b].samples[r] = run_once(&benchmarks[b].initial, instructions,
+                                                benchmarks[b].with_timers, benchmarks[b].aot);
+        }
+    }
+}
+
+// Calcula media, desviación típica, mediana y mínimo de las muestras
+static void summarize(result_t *result, benchmark_t *benchmark, int runs) {
+    double *samples = benchmark->samples;
+
+    double sum = 0.0;
+    for (int r = 0; r < runs; r++) {
+        sum += samples[r];
+    }
+    double mean = sum / runs;
+
+    double variance = 0.0;
+    for (int r = 0; r < runs; r++) {
+        variance += (samples[r] - mean) * (samples[r] - mean);
+    }
+    variance /= runs;
+
+    qsort(samples, runs, sizeof(double), compare_double);
+
+    memcpy(result->name, benchmark->name, MAX_NAME);
+    result->ns_mean = mean;
+    result->ns_stddev = sqrt(variance);
+    result->ns_median = samples[runs / 2];
+    result->ns_min = samples[0];
+    result->ips = 1e9 / result->ns_min;
+
+    printf("%-40s %8.2f ns/instr  (mediana %8.2f +/- %5.2f)  %12.0f instr/s\n",
+           result->name, result->ns_min, result->ns_median, result->ns_stddev, result->ips);
+}
+
+// --- JSON ---
+
+// Escribe una cadena JSON escapando comillas y barras invertidas
+static void json_string(FILE *f, const char *s) {
+    fputc('"', f);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            fputc('\\', f);
+        }
+        fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+static bool write_json(const char *path, const result_t *results, int count,
+                       long instructions, int runs) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "Error: No se pudo escribir %s\n", path);
+        return false;
+    }
+
+    fprintf(f, "{\n  \"instructions\": %ld,\n  \"runs\": %d,\n  \"benchmarks\": [\n",
+            instructions, runs);
+    for (int i = 0; i < count; i++) {
+        fprintf(f, "    {\"name\": ");
+        json_string(f, results[i].name);
+        fprintf(f, ", \"ns_per_instr_mean\": %.4f, \"ns_per_instr_stddev\": %.4f, "
+                   "\"ns_per_instr_median\": %.4f, \"ns_per_instr_min\": %.4f, \"ips\": %.1f}%s\n",
+                results[i].ns_mean, results[i].ns_stddev, results[i].ns_median,
+                results[i].ns_min, results[i].ips, (i + 1 < count) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+
+    fclose(f);
+    return true;
+}
+
+// Lee un archivo completo en memoria (terminado en '\0')
+static char *read_file(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    rewind(f);
+
+    char *text = malloc(size + 1);
+    if (text) {
+        size_t read = fread(text, 1, size, f);
+        text[read] = '\0';
+    }
+    fclose(f);
+    return text;
+}
+
+// Busca en el JSON del baseline el campo 'field' del benchmark 'name'.
+// Solo entiende el formato que genera write_json(), no es un parser general.
+static double baseline_value(const char *json, const char *name, const char *field) {
+    // Mismo escapado que json_string()
+    char key[2 * MAX_NAME + 16] = "\"name\": \"";
+    size_t length = strlen(key);
+    for (; *name; name++) {
+        if (*name == '"' || *name == '\\') {
+            key[length++] = '\\';
+        }
+        key[length++] = *name;
+    }
+    key[length++] = '"';
+    key[length] = '\0';
+
+    const char *entry = strstr(json, key);
+    if (!entry) {
+        return -1.0;
+    }
+    const char *end = strchr(entry, '}');
+
+    char field_key[64];
+    snprintf(field_key, sizeof(field_key), "\"%s\":", field);
+    const char *value = strstr(entry, field_key);
+    if (!value || (end && value > end)) {
+        return -1.0;
+    }
+    return strtod(value + strlen(field_key), NULL);
+}
+
+// Lee el siguiente nombre de benchmark del baseline a partir de 'json'.
+// Devuelve por dónde seguir buscando, o NULL si no quedan más.
+static const char *next_baseline_name(const char *json, char *name) {
+    const char *key = "\"name\": \"";
+    const char *entry = strstr(json, key);
+    if (!entry) {
+        return NULL;
+    }
+    const char *c = entry + strlen(key);
+    int length = 0;
+    for (; *c && *c != '"'; c++) {
+        if (*c == '\\' && c[1]) {
+            c++;
+        }
+        if (length < MAX_NAME - 1) {
+            name[length++] = *c;
+        }
+    }
+    name[length] = '\0';
+    return c;
+}
+
+// Compara con el baseline. Devuelve el número de regresiones, o -1 si no
+// se puede leer: sin baseline no hay nada contra lo que comprobar y la
+// comparación no debe darse por buena.
+// Un benchmark que no está en el baseline, o uno del baseline que ya no se
+// mide (renombrado, quitado, una ROM que no cargó), también cuenta como fallo:
+// si no, un cambio en la lista de pruebas pasaría el control sin comparar nada.
+static int compare_baseline(const char *path, const result_t *results, int count,
+                            double threshold) {
+    char *json = read_file(path);
+    if (!json) {
+        fprintf(stderr, "\nError: no hay baseline en %s (genéralo con make bench-baseline).\n", path);
+        return -1;
+    }
+
+    int regressions = 0;
+    printf("\nComparación con %s (umbral %.1f%% y %.0f sigma):\n", path, threshold, REGRESSION_SIGMAS);
+    for (int i = 0; i < count; i++) {
+        double base = baseline_value(json, results[i].name, "ns_per_instr_min");
+        double sigma = baseline_value(json, results[i].name, "ns_per_instr_stddev");
+        if (base <= 0.0) {
+            printf("  %-40s FALTA EN EL BASELINE\n", results[i].name);
+            regressions++;
+            continue;
+        }
+
+        // Cambio en instrucciones/s: negativo = más lento
+        double change = (base / results[i].ns_min - 1.0) * 100.0;
+        bool regressed = change < -threshold &&
+                         results[i].ns_min - base > REGRESSION_SIGMAS * sigma;
+        printf("  %-40s %+7.1f%% %s\n", results[i].name, change,
+               regressed ? "REGRESIÓN" : "ok");
+        if (regressed) {
+            regressions++;
+        }
+    }
+
+    char name[MAX_NAME];
+    for (const char *c = next_baseline_name(json, name); c; c = next_baseline_name(c, name)) {
+        bool found = false;
+        for (int i = 0; i < count && !found; i++) {
+            found = strcmp(results[i].name, name) == 0;
+        }
+        if (!found) {
+            printf("  %-40s YA NO SE MIDE\n", name);
+            regressions++;
+        }
+    }
+
+    free(json);
+    return regressions;
+}
+
+// --- MODO AOT ---
+
+// Traduce una ROM con tools/aot y carga el módulo resultante
+static bool aot_translate(chip8_aot_t *aot, const char *translator, const char *rom_path, int index) {
+    char source[256];
+    char module[256];
+    snprintf(source, sizeof(source), "%s_%d.c", AOT_WORK_PREFIX, index);
+    snprintf(module, sizeof(module), "%s_%d.so", AOT_WORK_PREFIX, index);
+
+    // Sin shell: las rutas de las ROMs pueden tener espacios, comillas, etc.
+    pid_t pid = fork();
+    if (pid == 0) {
+        int null = open("/dev/null", O_WRONLY);
+        if (null >= 0) {
+            dup2(null, STDOUT_FILENO);
+        }
+        execl(translator, translator, rom_path, source, module, (char *)NULL);
+        _exit(127);
+    }
+    int status;
+    if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "Error: no se pudo traducir %s\n", rom_path);
+        return false;
+    }
+    return chip8_aot_load(aot, module);
+}
+
+// Prepara un benchmark más. Devuelve NULL si ya no caben.
+static benchmark_t *add_benchmark(benchmark_t *benchmarks, int *count, const char *name,
+                                  const chip8_t *initial, bool with_timers, int runs) {
+    if (*count >= MAX_BENCHMARKS) {
+        fprintf(stderr, "Aviso: más de %d benchmarks, se omite %s\n", MAX_BENCHMARKS, name);
+        return NULL;
+    }
+    benchmark_t *benchmark = &benchmarks[(*count)++];
+    snprintf(benchmark->name, MAX_NAME, "%s", name);
+    benchmark->initial = *initial;
+    benchmark->with_timers = with_timers;
+    benchmark->aot = NULL;
+    benchmark->samples = malloc(sizeof(double) * runs);
+    return benchmark;
+}
+
+// Prepara el mismo programa con código nativo, como "aot:<nombre>"
+static bool add_aot_benchmark(benchmark_t *benchmarks, int *count, const char *name,
+                              const char *translator, const char *rom_path, int index,
+                              const chip8_t *initial, bool with_timers, int runs) {
+    // En el heap: las tablas por dirección de chip8_aot_t ocupan unos 69KB
+    chip8_aot_t *aot = calloc(1, sizeof(chip8_aot_t));
+    if (!aot || !aot_translate(aot, translator, rom_path, index)) {
+        free(aot);
+        return false;
+    }
+    char aot_name[MAX_NAME];
+    snprintf(aot_name, sizeof(aot_name), "aot:%.*s", MAX_NAME - 5, name);
+    benchmark_t *benchmark = add_benchmark(benchmarks, count, aot_name, initial, with_timers, runs);
+    if (!benchmark) {
+        chip8_aot_unload(aot);
+        free(aot);
+        return true;
+    }
+    benchmark->aot = aot;
+    return true;
+}
+
+// Guarda un programa sintético como ROM para poder traducirlo
+static bool write_synthetic(const char *path, const synthetic_rom_t *rom) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "Error: No se pudo escribir %s\n", path);
+        return false;
+    }
+    for (int op = 0; op < rom->length; op++) {
+        fputc(rom->code[op] >> 8, f);
+        fputc(rom->code[op] & 0xFF, f);
+    }
+    fclose(f);
+    return true;
+}
+
+// Nombre corto de una ROM: sin directorios ni extensión
+static void rom_name(char *out, const char *path) {
+    const char *base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+    snprintf(out, MAX_NAME, "rom:%s", base);
+
+    char *dot = strrchr(out, '.');
+    if (dot) {
+        *dot = '\0';
+    }
+}
+
+int main(int argc, char **argv) {
+    long instructions = 2000000;
+    int runs = 10;
+    const char *output = "bench_output.json";
+    const char *baseline = NULL;
+    const char *translator = NULL;
+    double threshold = 10.0;
+
+    // Argumentos: opciones primero, después la lista de ROMs
+    int arg = 1;
+    for (; arg < argc && argv[arg][0] == '-'; arg++) {
+        if (arg + 1 >= argc) {
+            fprintf(stderr, "Error: falta el valor de %s\n", argv[arg]);
+            return 2;
+        }
+        switch (argv[arg][1]) {
+            case 'n': instructions = atol(argv[++arg]); break;
+            case 'r': runs = atoi(argv[++arg]); break;
+            case 'o': output = argv[++arg]; break;
+            case 'b': baseline = argv[++arg]; break;
+            case 't': threshold = atof(argv[++arg]); break;
+            case 'a': translator = argv[++arg]; break;
+            default:
+                fprintf(stderr, "Uso: %s [-n instr] [-r runs] [-o out.json] "
+                                "[-b baseline.json] [-t umbral_%%] [-a traductor] [rom.ch8 ...]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (instructions < 1 || runs < 1) {
+        fprintf(stderr, "Error: -n y -r deben ser >= 1\n");
+        return 2;
+    }
+
+    static benchmark_t benchmarks[MAX_BENCHMARKS];    // static: cada uno guarda un chip8_t
+    static result_t results[MAX_BENCHMARKS];
+    static chip8_t initial;
+    int count = 0;
+
+    // 1. Programas sintéticos: aislan cada clase de opcode
+    int synthetic_count = (int)(sizeof(synthetic_roms) / sizeof(synthetic_roms[0]));
+    for (int i = 0; i < synthetic_count; i++) {
+        const synthetic_rom_t *rom = &synthetic_roms[i];
+        chip8_init(&initial);
+        for (int op = 0; op < rom->length; op++) {
+            initial.memory[START_ADDRESS + op * 2]     = rom->code[op] >> 8;
+            initial.memory[START_ADDRESS + op * 2 + 1] = rom->code[op] & 0xFF;
+        }
+        add_benchmark(benchmarks, &count, rom->name, &initial, false, runs);
+
+        if (translator) {
+            char path[256];
+            snprintf(path, sizeof(path), "%s_%d.ch8", AOT_WORK_PREFIX, i);
+            if (!write_synthetic(path, rom) ||
+                !add_aot_benchmark(benchmarks, &count, rom->name, translator, path, i,
+                                   &initial, false, runs)) {
+                return 2;
+            }
+        }
+    }
+
+    // 2. ROMs completas, con teclas pulsadas y los timers a 60Hz simulados
+    for (; arg < argc; arg++) {
+        chip8_init(&initial);
+        if (!chip8_load_rom(&initial, argv[arg])) {
+            return 2;
+        }
+        char name[MAX_NAME];
+        rom_name(name, argv[arg]);
+        add_benchmark(benchmarks, &count, name, &initial, true, runs);
+
+        if (translator &&
+            !add_aot_benchmark(benchmarks, &count, name, translator, argv[arg],
+                               synthetic_count + arg, &initial, true, runs)) {
+            return 2;
+        }
+    }
+
+    printf("%d benchmarks: %ld instrucciones x %d rondas\n\n", count, instructions, runs);
+    measure_all(benchmarks, count, instructions, runs);
+    for (int b = 0; b < count; b++) {
+        summarize(&results[b], &benchmarks[b], runs);
+        if (benchmarks[b].aot) {
+            chip8_aot_unload(benchmarks[b].aot);
+            free(benchmarks[b].aot);
+        }
+        free(benchmarks[b].samples);
+    }
+
+    if (!write_json(output, results, count, instructions, runs)) {
+        return 2;
+    }
+    printf("\nResultados guardados en %s\n", output);
+
+    if (baseline) {
+        int regressions = compare_baseline(baseline, results, count, threshold);
+        if (regressions < 0) {
+            return 2;
+        }
+        if (regressions > 0) {
+            printf("\n%d benchmark(s) por debajo del umbral o sin comparar.\n", regressions);
+            return 1;
+        }
+    }
+
+    return 0;
+}
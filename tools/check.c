@@ -0,0 +1,365 @@
+// Comprobaciones de corrección del núcleo CHIP-8 (make check).
+//
+// Ejecuta cada ROM de la línea de comandos y unos programas de prueba incluidos
+// aquí (código automodificable y casos de fallo) con teclas pulsadas y los
+// timers a 60Hz, igual que las ROMs de tools/bench.c, y comprueba:
+//
+//   - que display_hash, que DXYN y 00E0 mantienen de forma incremental,
+//     coincide con el hash recalculado desde cero después de cada instrucción;
+//   - con -a <traductor> (build/aot), que el módulo nativo deja exactamente el
+//     mismo estado que el intérprete al final de cada frame: memoria, registros,
+//     pila, pantalla y su hash, timers, fallos y generador aleatorio.
+//
+// Los programas automodificables escriben con FX33/FX55 sobre código ya
+// traducido, así que también comprueban que written_start/written_end
+// invalidan los bloques afectados (ver chip8_aot_run).
+//
+// Devuelve 0 si todo coincide, 1 si algo falla y 2 si no se pudo comprobar.
+//
+// Uso: check [-f frames] [-a traductor] [rom.ch8 ...]
+
+#define _POSIX_C_SOURCE 199309L     // Para fork y waitpid
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>      // Para open
+#include <unistd.h>     // Para fork, dup2 y execl
+#include <sys/wait.h>   // Para waitpid
+#include "chip8.h"
+#include "aot.h"
+
+// Instrucciones por frame (igual que CYCLES_PER_FRAME en main.c)
+#define CYCLES_PER_FRAME 10
+
+// Frames que se mantiene pulsada cada tecla. Después de la 0xF viene un
+// tramo sin ninguna, para que las esperas FX0A también se ejerciten.
+#define KEY_HOLD_FRAMES 30
+
+// Archivos intermedios del modo AOT (programa de prueba, C generado y .so)
+#define AOT_WORK_PREFIX "build/check_aot"
+
+// Programa de prueba: lista de opcodes que se copian a partir de START_ADDRESS
+typedef struct {
+    const char *name;
+    const uint16_t *code;
+    int length;
+} test_rom_t;
+
+// --- CÓDIGO AUTOMODIFICABLE ---
+// Si alguno ejecutara aunque fuera una vez la versión antigua de la instrucción
+// reescrita, el registro que cambia se vería distinto al final del frame.
+
+// FX55 reescribe un bloque que todavía no se ha ejecutado
+static const uint16_t rom_smc_ahead[] = {
+    0xA20A,             // 0x200: I = 0x20A
+    0x6061, 0x6109,     // 0x202: V0 = 0x61, V1 = 0x09
+    0xF155,             // 0x206: memoria[0x20A..0x20B] = 61 09
+    0x120A,             // 0x208: JP 0x20A
+    0x6005,             // 0x20A: pasa a ser 6109
+    0x120C              // 0x20C: JP 0x20C
+};
+
+// FX55 pisa la instrucción que le sigue dentro de su propio bloque
+static const uint16_t rom_smc_next[] = {
+    0xA206,             // 0x200: I = 0x206
+    0x6061,             // 0x202: V0 = 0x61
+    0xF055,             // 0x204: memoria[0x206] = 61
+    0x6005,             // 0x206: pasa a ser 6105
+    0x1208              // 0x208: JP 0x208
+};
+
+// FX55 reescribe, a mitad de instrucción, un bloque que ya se ejecutó:
+// la siguiente vuelta tiene que ver el código nuevo
+static const uint16_t rom_smc_behind[] = {
+    0xA205,             // 0x200: I = 0x205 (segundo byte de 0x204)
+    0x6042,             // 0x202: V0 = 0x42
+    0x7107,             // 0x204: V1 += 0x07, pasa a ser 7142
+    0x7301,             // 0x206: V3 += 1
+    0xF055,             // 0x208: memoria[0x205] = 42
+    0x7201,             // 0x20A: V2 += 1
+    0x1204              // 0x20C: JP 0x204
+};
+
+// Igual, pero lo escrito cae detrás del FX55 en el mismo bloque, que ya está
+// validado cuando se vuelve a entrar en él
+static const uint16_t rom_smc_loop[] = {
+    0xA20B,             // 0x200: I = 0x20B (segundo byte de 0x20A)
+    0x6042,             // 0x202: V0 = 0x42
+    0x7201,             // 0x204: V2 += 1
+    0x7301,             // 0x206: V3 += 1
+    0xF055,             // 0x208: memoria[0x20B] = 42
+    0x7107,             // 0x20A: V1 += 0x07, pasa a ser 7142
+    0x1204              // 0x20C: JP 0x204
+};
+
+// FX33 escribe en cada vuelta el BCD de un contador sobre las dos instrucciones
+// siguientes (0x208 queda como 0NNN, que se ignora)
+static const uint16_t rom_smc_bcd[] = {
+    0xA207,             // 0x200: I = 0x207 (segundo byte de 0x206)
+    0x6009,             // 0x202: V0 = 9
+    0xF033,             // 0x204: memoria[0x207..0x209] = BCD(V0)
+    0x7155,             // 0x206: V1 += 0x55, pasa a ser 71<centenas>
+    0x7101,             // 0x208: pasa a ser 0<decenas><unidades>
+    0x7001,             // 0x20A: V0 += 1
+    0x1204              // 0x20C: JP 0x204
+};
+
+// --- FALLOS ---
+
+// CALL recursivo hasta llenar la pila
+static const uint16_t rom_stack_overflow[] = {
+    0x2200
+};
+
+// RET con la pila vacía
+static const uint16_t rom_stack_underflow[] = {
+    0x00EE, 0x1200
+};
+
+// EX9E con Vx > 0xF
+static const uint16_t rom_key_range[] = {
+    0x6020, 0xE09E, 0x1200
+};
+
+// FX65 que se sale de la RAM
+static const uint16_t rom_i_range[] = {
+    0xAFFE, 0xF565, 0x6001, 0x1200
+};
+
+#define TEST_ROM(name, code) { name, code, (int)(sizeof(code) / sizeof(code[0])) }
+
+static const test_rom_t test_roms[] = {
+    TEST_ROM("smc:ahead", rom_smc_ahead),
+    TEST_ROM("smc:next", rom_smc_next),
+    TEST_ROM("smc:behind", rom_smc_behind),
+    TEST_ROM("smc:loop", rom_smc_loop),
+    TEST_ROM("smc:bcd", rom_smc_bcd),
+    TEST_ROM("fault:stack_overflow", rom_stack_overflow),
+    TEST_ROM("fault:stack_underflow", rom_stack_underflow),
+    TEST_ROM("fault:key_range", rom_key_range),
+    TEST_ROM("fault:i_range", rom_i_range),
+};
+
+// Primer campo en el que difieren dos máquinas, o NULL si son iguales.
+// written_start/written_end no cuentan: chip8_aot_run() los consume.
+static const char *state_diff(const chip8_t *a, const chip8_t *b) {
+#define SAME(field) (memcmp(&a->field, &b->field, sizeof(a->field)) == 0)
+    if (!SAME(memory))       return "memory";
+    if (!SAME(V))            return "V";
+    if (!SAME(I))            return "I";
+    if (!SAME(pc))           return "pc";
+    if (!SAME(stack))        return "stack";
+    if (!SAME(sp))           return "sp";
+    if (!SAME(display))      return "display";
+    if (!SAME(display_hash)) return "display_hash";
+    if (!SAME(delay_timer))  return "delay_timer";
+    if (!SAME(sound_timer))  return "sound_timer";
+    if (!SAME(rng_state))    return "rng_state";
+    if (!SAME(fault))        return "fault";
+    if (!SAME(fault_opcode)) return "fault_opcode";
+    if (!SAME(fault_pc))     return "fault_pc";
+#undef SAME
+    return NULL;
+}
+
+// Teclado del frame: una tecla cada vez y, al final de la vuelta, ninguna
+static void press_keys(chip8_t *chip8, int frame) {
+    memset(chip8->keypad, 0, sizeof(chip8->keypad));
+    int key = (frame / KEY_HOLD_FRAMES) % (NUM_KEYS + 1);
+    if (key < NUM_KEYS) {
+        chip8->keypad[key] = true;
+    }
+}
+
+// Intérprete: display_hash tiene que coincidir con el recalculado tras cada instrucción
+static bool check_hash(const char *name, const chip8_t *initial, int frames) {
+    static chip8_t chip8;   // static: chip8_t ocupa más de 6KB
+    chip8 = *initial;
+
+    for (int frame = 0; frame < frames; frame++) {
+        press_keys(&chip8, frame);
+        for (int c = 0; c < CYCLES_PER_FRAME; c++) {
+            uint16_t pc = chip8.pc;
+            chip8_cycle(&chip8);
+            if (chip8_display_hash(&chip8) != chip8_display_hash_full(&chip8)) {
+                printf("FALLO %s: display_hash incorrecto tras la instrucción de 0x%03X "
+                       "(frame %d)\n", name, pc, frame);
+                return false;
+            }
+        }
+        chip8_update_timers(&chip8);
+    }
+    return true;
+}
+
+// Traduce una ROM con build/aot y carga el módulo resultante
+static bool aot_translate(chip8_aot_t *aot, const char *translator, const char *rom_path, int index) {
+    char source[256];
+    char module[256];
+    snprintf(source, sizeof(source), "%s_%d.c", AOT_WORK_PREFIX, index);
+    snprintf(module, sizeof(module), "%s_%d.so", AOT_WORK_PREFIX, index);
+
+    // Sin shell: las rutas de las ROMs pueden tener espacios, comillas, etc.
+    pid_t pid = fork();
+    if (pid == 0) {
+        int null = open("/dev/null", O_WRONLY);
+        if (null >= 0) {
+            dup2(null, STDOUT_FILENO);
+        }
+        execl(translator, translator, rom_path, source, module, (char *)NULL);
+        _exit(127);
+    }
+    int status;
+    if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "Error: no se pudo traducir %s\n", rom_path);
+        return false;
+    }
+    return chip8_aot_load(aot, module);
+}
+
+// Intérprete y módulo AOT frame a frame: el estado tiene que ser idéntico
+static bool check_aot(const char *name, const chip8_t *initial, int frames, chip8_aot_t *aot) {
+    static chip8_t interpreted;
+    static chip8_t translated;
+    interpreted = *initial;
+    translated = *initial;
+
+    for (int frame = 0; frame < frames; frame++) {
+        press_keys(&interpreted, frame);
+        press_keys(&translated, frame);
+        for (int c = 0; c < CYCLES_PER_FRAME; c++) {
+            chip8_cycle(&interpreted);
+        }
+        chip8_aot_run(aot, &translated, CYCLES_PER_FRAME);
+        chip8_update_timers(&interpreted);
+        chip8_update_timers(&translated);
+
+        const char *field = state_diff(&interpreted, &translated);
+        if (field) {
+            printf("FALLO aot:%s: %s distinto al final del frame %d "
+                   "(PC 0x%03X en el intérprete, 0x%03X con AOT)\n",
+                   name, field, frame, interpreted.pc, translated.pc);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Guarda un programa de prueba como ROM para poder traducirlo
+static bool write_test_rom(const char *path, const test_rom_t *rom) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "Error: No se pudo escribir %s\n", path);
+        return false;
+    }
+    for (int op = 0; op < rom->length; op++) {
+        fputc(rom->code[op] >> 8, f);
+        fputc(rom->code[op] & 0xFF, f);
+    }
+    fclose(f);
+    return true;
+}
+
+// Ejecuta las comprobaciones de un programa. Devuelve cuántas fallaron, o -1
+// si no se pudo comprobar.
+static int check_rom(const char *name, const chip8_t *initial, int frames,
+                     const char *translator, const char *rom_path, int index) {
+    int failures = 0;
+    if (!check_hash(name, initial, frames)) {
+        failures++;
+    }
+
+    if (translator) {
+        // En el heap: las tablas por dirección de chip8_aot_t ocupan unos 69KB
+        chip8_aot_t *aot = calloc(1, sizeof(chip8_aot_t));
+        if (!aot || !aot_translate(aot, translator, rom_path, index)) {
+            free(aot);
+            return -1;
+        }
+        if (!check_aot(name, initial, frames, aot)) {
+            failures++;
+        }
+        chip8_aot_unload(aot);
+        free(aot);
+    }
+
+    if (failures == 0) {
+        printf("ok   %s\n", name);
+    }
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    int frames = 600;
+    const char *translator = NULL;
+
+    // Argumentos: opciones primero, después la lista de ROMs
+    int arg = 1;
+    for (; arg < argc && argv[arg][0] == '-'; arg++) {
+        if (arg + 1 >= argc) {
+            fprintf(stderr, "Error: falta el valor de %s\n", argv[arg]);
+            return 2;
+        }
+        switch (argv[arg][1]) {
+            case 'f': frames = atoi(argv[++arg]); break;
+            case 'a': translator = argv[++arg]; break;
+            default:
+                fprintf(stderr, "Uso: %s [-f frames] [-a traductor] [rom.ch8 ...]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (frames < 1) {
+        fprintf(stderr, "Error: -f debe ser >= 1\n");
+        return 2;
+    }
+
+    static chip8_t initial;
+    int failures = 0;
+    int checked = 0;
+
+    // 1. Programas de prueba incluidos
+    int test_count = (int)(sizeof(test_roms) / sizeof(test_roms[0]));
+    for (int i = 0; i < test_count; i++) {
+        const test_rom_t *rom = &test_roms[i];
+        chip8_init(&initial);
+        for (int op = 0; op < rom->length; op++) {
+            initial.memory[START_ADDRESS + op * 2]     = rom->code[op] >> 8;
+            initial.memory[START_ADDRESS + op * 2 + 1] = rom->code[op] & 0xFF;
+        }
+
+        char path[256];
+        snprintf(path, sizeof(path), "%s_%d.ch8", AOT_WORK_PREFIX, i);
+        if (translator && !write_test_rom(path, rom)) {
+            return 2;
+        }
+        int result = check_rom(rom->name, &initial, frames, translator, path, i);
+        if (result < 0) {
+            return 2;
+        }
+        failures += result;
+        checked++;
+    }
+
+    // 2. ROMs completas
+    for (; arg < argc; arg++) {
+        chip8_init(&initial);
+        if (!chip8_load_rom(&initial, argv[arg])) {
+            return 2;
+        }
+        int result = check_rom(argv[arg], &initial, frames, translator, argv[arg],
+                               test_count + arg);
+        if (result < 0) {
+            return 2;
+        }
+        failures += result;
+        checked++;
+    }
+
+    if (failures > 0) {
+        printf("\n%d comprobación(es) fallida(s) en %d programas.\n", failures, checked);
+        return 1;
+    }
+    printf("\n%d programas comprobados%s.\n", checked, translator ? " (intérprete y AOT)" : "");
+    return 0;
+}
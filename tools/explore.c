@@ -0,0 +1,531 @@
+// Explorador del espacio de estados de una ROM.
+//
+// Parte del estado inicial (reset + ROM cargada) y, en cada frame, prueba
+// un conjunto de combinaciones de teclado. Las 65536 máscaras posibles no
+// son abarcables, así que por defecto se prueba "ninguna tecla" y cada tecla
+// por separado; con -n se añaden las combinaciones de hasta N teclas a la vez
+// (-n 2: también las parejas) y con -m se da la lista exacta de máscaras.
+// Cada estado resultante se
+// resume en un hash de 64 bits; los repetidos se descartan mediante un
+// conjunto de hashes compartido entre hilos. La búsqueda es en anchura
+// (un nivel = un frame), así que cada fallo se informa con la secuencia de
+// teclas más corta que lo reproduce.
+//
+// Informa de los fallos que registra el núcleo (CHIP8_FAULT_*): opcodes
+// desconocidos, desbordamientos de pila, accesos fuera de la RAM y teclas
+// fuera de rango en EX9E/EXA1.
+//
+// Uso: explore [-f frames] [-s estados] [-j hilos] [-c ciclos_por_frame]
+//              [-k teclas] [-n teclas_a_la_vez] [-m máscaras] rom.ch8
+//   -k limita las teclas a probar, por ejemplo "456" (por defecto todas).
+//   -n combina hasta N de esas teclas en el mismo frame (por defecto 1).
+//   -m sustituye todo lo anterior por máscaras hexadecimales, por ejemplo "0,30,8001".
+
+#define _POSIX_C_SOURCE 200809L     // Para pthreads, sysconf y clock_gettime
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "chip8.h"
+
+#define DEFAULT_FRAMES 600          // 10 segundos de juego a 60Hz
+#define DEFAULT_STATES 20000        // Nodos del árbol de caminos (6 bytes cada uno)
+#define DEFAULT_CYCLES_PER_FRAME 10 // Igual que CYCLES_PER_FRAME en main.c
+
+#define MAX_CHOICES 1024            // Combinaciones de teclado por frame
+#define MAX_REPORTS 256
+#define TASK_CHUNK 8                // Tareas que coge un hilo de golpe
+
+// Nodo del árbol de búsqueda: solo lo necesario para reconstruir la secuencia.
+typedef struct {
+    uint32_t parent;    // Índice del nodo padre (el nodo 0 es el reset)
+    uint16_t keys;      // Máscara de teclas pulsadas durante este frame
+} node_t;
+
+// Fallo encontrado, con el nodo desde el que se llegó y el último frame
+typedef struct {
+    uint8_t fault;
+    uint16_t opcode;
+    uint16_t pc;
+    uint32_t parent;
+    uint16_t keys;
+    int depth;
+} report_t;
+
+// Estado compartido de la exploración
+typedef struct {
+    int cycles_per_frame;
+    uint16_t choices[MAX_CHOICES];
+    int choice_count;
+
+    // Árbol de caminos (crece durante toda la búsqueda)
+    node_t *nodes;
+    uint32_t node_capacity;
+    volatile uint32_t node_count;
+
+    // Conjunto de hashes vistos: direccionamiento abierto, 0 = hueco libre
+    volatile uint64_t *seen;
+    uint64_t seen_mask;
+    volatile uint32_t duplicates;
+
+    // Frontera actual y siguiente (un nivel por frame). Cada estado ocupa ~6KB,
+    // así que crecen según hace falta en cada nivel (ver reserve_frontier)
+    chip8_t *current;
+    uint32_t *current_ids;
+    uint32_t current_count;
+    uint32_t current_capacity;
+    chip8_t *next;
+    uint32_t *next_ids;
+    volatile uint32_t next_count;
+    uint32_t next_capacity;
+
+    // Reparto de trabajo: tarea = (estado de la frontera, elección de teclas)
+    volatile uint32_t next_task;
+    uint32_t task_count;
+    volatile int budget_exhausted;
+    int depth;
+
+    // Fallos encontrados
+    pthread_mutex_t report_lock;
+    report_t reports[MAX_REPORTS];
+    int report_count;
+} explorer_t;
+
+// --- HASH DE ESTADO ---
+
+// Mezcla final de splitmix64: reparte bien los bits para la tabla
+static uint64_t mix64(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return h;
+}
+
+static uint64_t hash_bytes(uint64_t h, const void *data, size_t size) {
+    const uint8_t *bytes = data;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, 8);
+        h = (h ^ word) * 0x100000001B3ull;
+        h ^= h >> 29;
+    }
+    for (; i < size; i++) {
+        h = (h ^ bytes[i]) * 0x100000001B3ull;
+    }
+    return h;
+}
+
+// Hash de todo lo que influye en el futuro de la máquina.
+// El teclado no cuenta: se sobreescribe antes de cada frame.
+static uint64_t state_hash(const chip8_t *chip8) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    h = hash_bytes(h, chip8->memory, sizeof(chip8->memory));
+    // La pantalla ya viene resumida por el núcleo (hash Zobrist incremental)
+    uint64_t display = chip8_display_hash(chip8);
+    h = hash_bytes(h, &display, sizeof(display));
+    h = hash_bytes(h, chip8->V, sizeof(chip8->V));
+    h = hash_bytes(h, chip8->stack, sizeof(chip8->stack));
+
+    uint64_t regs = (uint64_t)chip8->I
+                  | ((uint64_t)chip8->pc << 16)
+                  | ((uint64_t)chip8->sp << 32)
+                  | ((uint64_t)chip8->delay_timer << 40)
+                  | ((uint64_t)chip8->sound_timer << 48);
+    h = hash_bytes(h, &regs, sizeof(regs));
+    h = hash_bytes(h, &chip8->rng_state, sizeof(chip8->rng_state));
+
+    h = mix64(h);
+    return h ? h : 1;   // 0 marca los huecos libres del conjunto
+}
+
+// Inserta un hash en el conjunto. Devuelve true si no estaba.
+static bool seen_insert(explorer_t *ex, uint64_t h) {
+    uint64_t index = h & ex->seen_mask;
+    for (uint64_t probes = 0; probes <= ex->seen_mask; probes++) {
+        uint64_t current = ex->seen[index];
+        if (current == h) {
+            return false;
+        }
+        if (current == 0) {
+            if (__sync_bool_compare_and_swap(&ex->seen[index], 0, h)) {
+                return true;
+            }
+            // Otro hilo ocupó el hueco: lo volvemos a mirar por si era el mismo hash
+            continue;
+        }
+        index = (index + 1) & ex->seen_mask;
+    }
+    return false;   // Tabla llena: tratamos el estado como visto
+}
+
+// --- EXPLORACIÓN ---
+
+static void add_report(explorer_t *ex, const chip8_t *chip8, uint32_t parent, uint16_t keys) {
+    pthread_mutex_lock(&ex->report_lock);
+
+    // Un informe por tipo de fallo y dirección: el primero es el camino más corto
+    bool known = false;
+    for (int i = 0; i < ex->report_count; i++) {
+        if (ex->reports[i].fault == chip8->fault && ex->reports[i].pc == chip8->fault_pc) {
+            known = true;
+            break;
+        }
+    }
+
+    if (!known && ex->report_count < MAX_REPORTS) {
+        report_t *r = &ex->reports[ex->report_count++];
+        r->fault = chip8->fault;
+        r->opcode = chip8->fault_opcode;
+        r->pc = chip8->fault_pc;
+        r->parent = parent;
+        r->keys = keys;
+        r->depth = ex->depth + 1;
+    }
+
+    pthread_mutex_unlock(&ex->report_lock);
+}
+
+// Ejecuta un frame con las teclas indicadas. Devuelve false si hubo un fallo.
+static bool run_frame(chip8_t *chip8, uint16_t keys, int cycles) {
+    for (int k = 0; k < NUM_KEYS; k++) {
+        chip8->keypad[k] = (keys >> k) & 1;
+    }
+    for (int c = 0; c < cycles; c++) {
+        chip8_cycle(chip8);
+        if (chip8->fault) {
+            return false;
+        }
+    }
+    chip8_update_timers(chip8);
+    return true;
+}
+
+static void expand(explorer_t *ex, chip8_t *scratch, uint32_t task) {
+    uint32_t state = task / ex->choice_count;
+    uint16_t keys = ex->choices[task % ex->choice_count];
+    uint32_t parent = ex->current_ids[state];
+
+    *scratch = ex->current[state];
+    if (!run_frame(scratch, keys, ex->cycles_per_frame)) {
+        add_report(ex, scratch, parent, keys);
+        return;
+    }
+
+    if (!seen_insert(ex, state_hash(scratch))) {
+        __sync_fetch_and_add(&ex->duplicates, 1);
+        return;
+    }
+
+    uint32_t id = __sync_fetch_and_add(&ex->node_count, 1);
+    uint32_t slot = __sync_fetch_and_add(&ex->next_count, 1);
+    if (id >= ex->node_capacity || slot >= ex->next_capacity) {
+        ex->budget_exhausted = 1;
+        return;
+    }
+
+    ex->nodes[id].parent = parent;
+    ex->nodes[id].keys = keys;
+    ex->next[slot] = *scratch;
+    ex->next_ids[slot] = id;
+}
+
+static void *worker(void *arg) {
+    explorer_t *ex = arg;
+    chip8_t *scratch = malloc(sizeof(chip8_t));
+    if (!scratch) {
+        return NULL;
+    }
+
+    while (!ex->budget_exhausted) {
+        uint32_t first = __sync_fetch_and_add(&ex->next_task, TASK_CHUNK);
+        if (first >= ex->task_count) {
+            break;
+        }
+        uint32_t last = first + TASK_CHUNK;
+        if (last > ex->task_count) {
+            last = ex->task_count;
+        }
+        for (uint32_t task = first; task < last && !ex->budget_exhausted; task++) {
+            expand(ex, scratch, task);
+        }
+    }
+
+    free(scratch);
+    return NULL;
+}
+
+// --- INFORME ---
+
+// Imprime la secuencia de teclas como "máscara x frames", de la raíz al fallo
+static void print_path(const explorer_t *ex, uint32_t node, uint16_t last_keys) {
+    int length = 0;
+    for (uint32_t n = node; n != 0; n = ex->nodes[n].parent) {
+        length++;
+    }
+
+    uint16_t *keys = malloc(sizeof(uint16_t) * (length + 1));
+    if (!keys) {
+        return;
+    }
+    int i = length;
+    keys[i] = last_keys;
+    for (uint32_t n = node; n != 0; n = ex->nodes[n].parent) {
+        keys[--i] = ex->nodes[n].keys;
+    }
+
+    printf("    teclas:");
+    for (int start = 0; start <= length; ) {
+        int end = start;
+        while (end + 1 <= length && keys[end + 1] == keys[start]) {
+            end++;
+        }
+        printf(" %04X x%d", keys[start], end - start + 1);
+        start = end + 1;
+    }
+    printf("\n");
+
+    free(keys);
+}
+
+// Asegura sitio en la siguiente frontera para los estados que puede producir
+// este nivel: uno por tarea, pero nunca más que los nodos que quedan.
+static bool reserve_frontier(explorer_t *ex) {
+    uint64_t needed = (uint64_t)ex->current_count * ex->choice_count;
+    uint32_t left = ex->node_capacity - ex->node_count;
+    if (needed > left) {
+        needed = left;
+    }
+    if (needed <= ex->next_capacity) {
+        return true;
+    }
+
+    // Al menos el doble, para no reservar en cada nivel mientras la frontera crece
+    uint64_t capacity = (uint64_t)ex->next_capacity * 2;
+    if (capacity < needed) {
+        capacity = needed;
+    }
+    if (capacity > left) {
+        capacity = left;
+    }
+    chip8_t *states = realloc(ex->next, sizeof(chip8_t) * capacity);
+    if (!states) {
+        return false;
+    }
+    ex->next = states;
+    uint32_t *ids = realloc(ex->next_ids, sizeof(uint32_t) * capacity);
+    if (!ids) {
+        return false;
+    }
+    ex->next_ids = ids;
+    ex->next_capacity = (uint32_t)capacity;
+    return true;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr, "Uso: %s [-f frames] [-s estados] [-j hilos] [-c ciclos_por_frame] "
+                    "[-k teclas] [-n teclas_a_la_vez] [-m máscaras] rom.ch8\n", program);
+}
+
+static int count_bits(unsigned value) {
+    int bits = 0;
+    for (; value; value &= value - 1) {
+        bits++;
+    }
+    return bits;
+}
+
+// Elecciones por frame: todas las máscaras de hasta max_pressed teclas de
+// key_list, de menos a más teclas (la primera es "ninguna tecla")
+static bool choices_from_keys(explorer_t *ex, const char *key_list, int max_pressed) {
+    unsigned allowed = 0;
+    for (const char *c = key_list; *c; c++) {
+        char digit[2] = { *c, '\0' };
+        char *end;
+        long key = strtol(digit, &end, 16);
+        if (*end != '\0' || key < 0 || key >= NUM_KEYS) {
+            fprintf(stderr, "Error: '%c' no es una tecla (0-F)\n", *c);
+            return false;
+        }
+        allowed |= 1u << key;
+    }
+
+    for (int pressed = 0; pressed <= max_pressed; pressed++) {
+        for (unsigned mask = 0; mask < (1u << NUM_KEYS); mask++) {
+            if ((mask & ~allowed) || count_bits(mask) != pressed) {
+                continue;
+            }
+            if (ex->choice_count == MAX_CHOICES) {
+                fprintf(stderr, "Error: más de %d combinaciones de teclas por frame\n", MAX_CHOICES);
+                return false;
+            }
+            ex->choices[ex->choice_count++] = (uint16_t)mask;
+        }
+    }
+    return true;
+}
+
+// Elecciones por frame dadas a mano: máscaras hexadecimales separadas por comas
+static bool choices_from_masks(explorer_t *ex, const char *masks) {
+    const char *c = masks;
+    while (*c) {
+        char *end;
+        unsigned long mask = strtoul(c, &end, 16);
+        if (!isxdigit((unsigned char)*c) || mask > 0xFFFF || (*end != ',' && *end != '\0')) {
+            fprintf(stderr, "Error: máscara de teclas no válida en \"%s\"\n", c);
+            return false;
+        }
+        if (ex->choice_count == MAX_CHOICES) {
+            fprintf(stderr, "Error: más de %d combinaciones de teclas por frame\n", MAX_CHOICES);
+            return false;
+        }
+        ex->choices[ex->choice_count++] = (uint16_t)mask;
+        c = (*end == ',') ? end + 1 : end;
+    }
+    return ex->choice_count > 0;
+}
+
+int main(int argc, char **argv) {
+    int max_frames = DEFAULT_FRAMES;
+    long max_states = DEFAULT_STATES;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    int cycles_per_frame = DEFAULT_CYCLES_PER_FRAME;
+    const char *key_list = "0123456789ABCDEF";
+    int max_pressed = 1;
+    const char *masks = NULL;
+
+    int arg = 1;
+    for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2) {
+        switch (argv[arg][1]) {
+            case 'f': max_frames = atoi(argv[arg + 1]); break;
+            case 's': max_states = atol(argv[arg + 1]); break;
+            case 'j': threads = atol(argv[arg + 1]); break;
+            case 'c': cycles_per_frame = atoi(argv[arg + 1]); break;
+            case 'k': key_list = argv[arg + 1]; break;
+            case 'n': max_pressed = atoi(argv[arg + 1]); break;
+            case 'm': masks = argv[arg + 1]; break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+    if (arg + 1 != argc || max_frames < 1 || max_states < 1 || cycles_per_frame < 1 ||
+        max_pressed < 0 || max_pressed > NUM_KEYS) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    static explorer_t ex;
+    ex.cycles_per_frame = cycles_per_frame;
+    pthread_mutex_init(&ex.report_lock, NULL);
+
+    if (masks ? !choices_from_masks(&ex, masks) : !choices_from_keys(&ex, key_list, max_pressed)) {
+        return 2;
+    }
+
+    // Reservas: el árbol de caminos, el conjunto de hashes y la frontera inicial
+    uint64_t seen_size = 1;
+    while (seen_size < (uint64_t)max_states * 4) {
+        seen_size <<= 1;
+    }
+    ex.node_capacity = (uint32_t)max_states + 1;
+    ex.nodes = calloc(ex.node_capacity, sizeof(node_t));
+    ex.seen = calloc(seen_size, sizeof(uint64_t));
+    ex.seen_mask = seen_size - 1;
+    ex.current = malloc(sizeof(chip8_t));
+    ex.current_ids = malloc(sizeof(uint32_t));
+    ex.current_capacity = 1;
+    if (!ex.nodes || !ex.seen || !ex.current || !ex.current_ids) {
+        fprintf(stderr, "Error: No hay memoria para %ld estados\n", max_states);
+        return 2;
+    }
+
+    // Nodo 0: la máquina recién reiniciada con la ROM cargada
+    chip8_init(&ex.current[0]);
+    if (!chip8_load_rom(&ex.current[0], argv[arg])) {
+        return 2;
+    }
+    ex.current_ids[0] = 0;
+    ex.current_count = 1;
+    ex.node_count = 1;
+    seen_insert(&ex, state_hash(&ex.current[0]));
+
+    pthread_t *pool = malloc(sizeof(pthread_t) * threads);
+    if (!pool) {
+        return 2;
+    }
+
+    printf("Explorando %s: %d frames, %ld estados, %ld hilos, %d opciones por frame\n",
+           argv[arg], max_frames, max_states, threads, ex.choice_count);
+    double start = now_seconds();
+
+    for (ex.depth = 0; ex.depth < max_frames && ex.current_count > 0 && !ex.budget_exhausted; ex.depth++) {
+        if (!reserve_frontier(&ex)) {
+            fprintf(stderr, "Error: No hay memoria para la frontera del frame %d\n", ex.depth + 1);
+            return 2;
+        }
+        ex.next_count = 0;
+        ex.next_task = 0;
+        ex.task_count = ex.current_count * ex.choice_count;
+
+        for (long t = 0; t < threads; t++) {
+            pthread_create(&pool[t], NULL, worker, &ex);
+        }
+        for (long t = 0; t < threads; t++) {
+            pthread_join(pool[t], NULL);
+        }
+
+        // La siguiente frontera pasa a ser la actual
+        chip8_t *states = ex.current;
+        uint32_t *ids = ex.current_ids;
+        uint32_t capacity = ex.current_capacity;
+        ex.current = ex.next;
+        ex.current_ids = ex.next_ids;
+        ex.current_capacity = ex.next_capacity;
+        ex.next = states;
+        ex.next_ids = ids;
+        ex.next_capacity = capacity;
+        ex.current_count = ex.next_count < ex.current_capacity ? ex.next_count : ex.current_capacity;
+    }
+
+    double elapsed = now_seconds() - start;
+    uint32_t states = ex.node_count < ex.node_capacity ? ex.node_count : ex.node_capacity;
+
+    printf("Frames: %d | Estados únicos: %u | Duplicados descartados: %u | %.2f s%s\n",
+           ex.depth, states, ex.duplicates, elapsed,
+           ex.budget_exhausted ? " (presupuesto de estados agotado)" : "");
+
+    printf("\nFallos encontrados: %d\n", ex.report_count);
+    for (int i = 0; i < ex.report_count; i++) {
+        const report_t *r = &ex.reports[i];
+        for (uint8_t bit = 1; bit != 0; bit <<= 1) {
+            if (r->fault & bit) {
+                printf("  [frame %d] %s: opcode 0x%04X en 0x%03X\n",
+                       r->depth, chip8_fault_name(bit), r->opcode, r->pc);
+            }
+        }
+        print_path(&ex, r->parent, r->keys);
+    }
+
+    free(pool);
+    free(ex.current);
+    free(ex.current_ids);
+    free(ex.next);
+    free(ex.next_ids);
+    free(ex.nodes);
+    free((void *)ex.seen);
+    return ex.report_count > 0 ? 1 : 0;
+}